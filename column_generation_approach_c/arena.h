@@ -0,0 +1,48 @@
+//
+// Single arena for the domain objects of one instance.
+//
+
+#ifndef LNO_ARENA_H
+#define LNO_ARENA_H
+
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <string_view>
+#include <utility>
+
+using namespace std;
+
+/** bump allocator releasing everything at once when it goes out of scope
+ *
+ *  Objects created with make() receive the arena as their memory resource (last
+ *  constructor argument), so their strings and containers live in the arena too.
+ *  Destructors are never run: objects must not own memory outside the arena.
+ */
+class Arena {
+public:
+  explicit Arena(size_t initialBytes = 1 << 16) : _resource(initialBytes){};
+
+  Arena(const Arena &) = delete;
+  Arena &operator=(const Arena &) = delete;
+
+  pmr::memory_resource *resource() { return &_resource; }
+
+  template <class T, class... Args> T *make(Args &&...args) {
+    void *p = _resource.allocate(sizeof(T), alignof(T));
+    return new (p) T(std::forward<Args>(args)..., &_resource);
+  };
+
+  /** copies a string into the arena, e.g. a json key that has to outlive the parser */
+  string_view intern(string_view s) {
+    char *p = static_cast<char *>(_resource.allocate(s.size() + 1, 1));
+    s.copy(p, s.size());
+    p[s.size()] = '\0';
+    return {p, s.size()};
+  };
+
+private:
+  pmr::monotonic_buffer_resource _resource;
+};
+
+#endif // LNO_ARENA_H
@@ -0,0 +1,232 @@
+//
+// Pricing with an embedded clingo program (multi-shot).
+//
+
+#include "asp_pricing.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <exception>
+#include <sstream>
+
+using namespace std;
+
+/** same rounding of the sizes as price_packing */
+static const double SIZE_EPS = 1e-9;
+
+/** integer weight of a scaled cost, -1 if it does not fit clingo's 32 bit weights */
+static long long scaled(double value, double scale) {
+  const double v = round(value * scale);
+  return v > INT_MAX ? -1 : (long long)v;
+}
+
+static vector<string> control_arguments(const AspPricingOptions &options) {
+  vector<string> args{"--opt-mode=opt", "--warn=none"};
+  args.insert(args.end(), options.arguments.begin(), options.arguments.end());
+  return args;
+}
+
+static vector<char const *> c_strings(const vector<string> &args) {
+  vector<char const *> out;
+  for (const auto &arg : args)
+    out.push_back(arg.c_str());
+  return out;
+}
+
+AspPricer::AspPricer(const Instance &instance, const AspPricingOptions &options)
+    : _instance(instance), _options(options),
+      _control(clingo::StringSpan(c_strings(control_arguments(options)))) {
+  _slotRoute.assign(instance.routeTR.size(), -1);
+  for (size_t r = 0; r < instance.R; ++r)
+    for (size_t k = instance.routeTRStart[r]; k < instance.routeTRStart[r + 1]; ++k)
+      _slotRoute[k] = (int)r;
+}
+
+string AspPricer::facts() const {
+  const Instance &inst = _instance;
+  const Settings &settings = inst.settings;
+  ostringstream out;
+
+  for (size_t p = 0; p < inst.P; ++p)
+    out << "product(" << p << "," << clingo::String(inst.products[p]->name.c_str()).to_string() << ").\n";
+  for (size_t r = 0; r < inst.R; ++r)
+    out << "route(" << r << "," << clingo::String(inst.routes[r]->from->name.c_str()).to_string() << ","
+        << clingo::String(inst.routes[r]->to->name.c_str()).to_string() << ").\n";
+  for (size_t p = 0; p < inst.P; ++p)
+    out << "partSize(" << p << "," << (int)ceil(inst.productSize[p] - SIZE_EPS) << ").\n";
+  for (unsigned b = 0; b < _bits; ++b)
+    out << "bitWeight(" << b << "," << (1LL << b) << ").\n";
+
+  for (size_t k = 0; k < inst.routeTR.size(); ++k) {
+    const int r = _slotRoute[k], tr = inst.routeTR[k];
+    if (r < 0 || !inst.enabled(r, tr))
+      continue;
+    const double distance = inst.routeDistance[k];
+    const int capacity = (int)floor(inst.trCapacity[tr] + SIZE_EPS);
+    out << "slot(" << k << "," << r << "," << tr << ").\n";
+    out << "slotCapacity(" << k << "," << capacity << ").\n";
+    out << "tripCost(" << k << ","
+        << scaled(distance * (inst.trCost[tr] + settings.co2Costs * inst.trCo2Emissions[tr]), _options.scale)
+        << ").\n";
+
+    const double transit = inst.trSpeed[tr] > 0 ? distance / inst.trSpeed[tr] : 0;
+    for (size_t p = 0; p < inst.P; ++p) {
+      const int size = (int)ceil(inst.productSize[p] - SIZE_EPS);
+      if (!inst.valid(p, tr) || !inst.active(r, p) || size <= 0 || capacity / size == 0)
+        continue;
+      out << "unitBound(" << p << "," << k << "," << capacity / size << ").\n";
+      const long long unit = scaled(settings.capitalCosts * inst.productValue[p] * transit, _options.scale);
+      if (unit != 0)
+        out << "unitCost(" << p << "," << k << "," << unit << ").\n";
+    }
+  }
+  return out.str();
+}
+
+bool AspPricer::init(const vector<string> &files, string &error) {
+  const Instance &inst = _instance;
+  const Settings &settings = inst.settings;
+
+  // every weight in the minimize statements has to fit 32 bits: N * 2^b for the duals, the
+  // scaled trip costs and N times the scaled capital cost of a unit
+  long long maxUnits = 1;
+  for (size_t k = 0; k < inst.routeTR.size(); ++k) {
+    const int r = _slotRoute[k], tr = inst.routeTR[k];
+    if (r < 0 || !inst.enabled(r, tr))
+      continue;
+    const double distance = inst.routeDistance[k];
+    const int capacity = (int)floor(inst.trCapacity[tr] + SIZE_EPS);
+    if (scaled(distance * (inst.trCost[tr] + settings.co2Costs * inst.trCo2Emissions[tr]), _options.scale) < 0) {
+      error = "trip cost too large for the scale " + to_string(_options.scale);
+      return false;
+    }
+    const double transit = inst.trSpeed[tr] > 0 ? distance / inst.trSpeed[tr] : 0;
+    for (size_t p = 0; p < inst.P; ++p) {
+      const int size = (int)ceil(inst.productSize[p] - SIZE_EPS);
+      if (!inst.valid(p, tr) || !inst.active(r, p) || size <= 0)
+        continue;
+      const long long units = capacity / size;
+      maxUnits = max(maxUnits, units);
+      if (scaled(units * settings.capitalCosts * inst.productValue[p] * transit, _options.scale) < 0) {
+        error = "capital cost too large for the scale " + to_string(_options.scale);
+        return false;
+      }
+    }
+  }
+  _bits = _options.bits;
+  while (_bits > 1 && maxUnits > (INT_MAX >> (_bits - 1)))
+    --_bits;
+
+  try {
+    for (const auto &file : files)
+      _control.load(file.c_str());
+    _control.add("base", {}, facts().c_str());
+    _control.ground({{"base", {}}});
+
+    const clingo::SymbolicAtoms atoms = _control.symbolic_atoms();
+    _dualLiteral.assign(inst.R * inst.P * _bits, 0);
+    _dualValue.assign(_dualLiteral.size(), -1);
+    for (size_t r = 0; r < inst.R; ++r)
+      for (size_t p = 0; p < inst.P; ++p) {
+        if (!inst.active(r, p))
+          continue;
+        for (unsigned b = 0; b < _bits; ++b) {
+          auto it = atoms.find(clingo::Function(
+              "dualBit", {clingo::Number((int)r), clingo::Number((int)p), clingo::Number((int)b)}));
+          if (it != atoms.end())
+            _dualLiteral[inst.rp(r, p) * _bits + b] = it->literal();
+        }
+      }
+    auto it = atoms.find(clingo::Function("farkasMode", {}));
+    if (it != atoms.end())
+      _farkasLiteral = it->literal();
+  } catch (const exception &e) {
+    error = e.what();
+    return false;
+  }
+  return true;
+}
+
+bool AspPricer::solve(const double *coverDuals, bool farkas, vector<vector<tuple<int, int>>> &items) {
+  const Instance &inst = _instance;
+  const long long saturated = (1LL << _bits) - 1;
+
+  // only the externals whose value changed since the last round are assigned again
+  auto assign = [&](clingo::literal_t literal, char &current, bool value) {
+    if (literal == 0 || current == (char)value)
+      return;
+    _control.assign_external(literal, value ? clingo::TruthValue::True : clingo::TruthValue::False);
+    current = (char)value;
+    ++_assignments;
+  };
+  assign(_farkasLiteral, _farkasValue, farkas);
+  for (size_t rp = 0; rp < inst.R * inst.P; ++rp) {
+    if (_dualLiteral[rp * _bits] == 0)
+      continue;
+    // negative duals never pay for a unit, as in the knapsack
+    const long long dual = min(saturated, (long long)llround(max(0.0, coverDuals[rp]) * _options.scale));
+    for (unsigned b = 0; b < _bits; ++b)
+      assign(_dualLiteral[rp * _bits + b], _dualValue[rp * _bits + b], (dual >> b) & 1);
+  }
+
+  // the last model of an optimization is the optimal one
+  items.assign(inst.routeTR.size(), {});
+  bool found = false;
+  for (const auto &model : _control.solve()) {
+    found = true;
+    for (auto &slotItems : items)
+      slotItems.clear();
+    for (const auto &symbol : model.symbols()) {
+      if (!symbol.match("packedOnRoute", 3))
+        continue;
+      const auto args = symbol.arguments();
+      items[args[1].number()].emplace_back(args[0].number(), args[2].number());
+    }
+  }
+  ++_solves;
+  return found;
+}
+
+bool AspPricer::price(const double *coverDuals, bool farkas, const PricingOptions &options,
+                      vector<Packing> &columns, vector<double> &redcosts, double &mostNegative, string &error) {
+  const Instance &inst = _instance;
+  vector<vector<tuple<int, int>>> items;
+  bool found = false;
+  try {
+    found = solve(coverDuals, farkas, items);
+  } catch (const exception &e) {
+    error = e.what();
+    return false;
+  }
+
+  vector<double> best(inst.R, 0.0);
+  size_t added = 0;
+  for (size_t k = 0; found && k < items.size(); ++k) {
+    if (items[k].empty())
+      continue;
+    Packing packing;
+    packing.route = _slotRoute[k];
+    packing.transportResource = inst.routeTR[k];
+    packing.distance = inst.routeDistance[k];
+    packing.items = std::move(items[k]);
+    sort(packing.items.begin(), packing.items.end());
+    packing.cost = packing_cost(inst, packing.transportResource, packing.distance, packing.items);
+
+    double redcost = farkas ? 0.0 : packing.cost;
+    for (const auto &item : packing.items)
+      redcost -= get<1>(item) * coverDuals[inst.rp(packing.route, get<0>(item))];
+    best[packing.route] = min(best[packing.route], redcost);
+
+    if (redcost < -options.tolerance && (options.maxColumns == 0 || added < options.maxColumns)) {
+      columns.push_back(std::move(packing));
+      redcosts.push_back(redcost);
+      ++added;
+    }
+  }
+
+  mostNegative = 0.0;
+  for (double b : best)
+    mostNegative = min(mostNegative, b);
+  return true;
+}
@@ -0,0 +1,71 @@
+//
+// Pricing with an embedded clingo program (multi-shot): for side constraints that are awkward
+// in the knapsack pricer. Needs clingo's C++ API: configure with -DLNO_WITH_CLINGO=ON.
+//
+
+#ifndef LNO_ASP_PRICING_H
+#define LNO_ASP_PRICING_H
+
+#include <string>
+#include <vector>
+
+#include <clingo.hh>
+
+#include "instance.h"
+#include "pricing.h"
+
+using namespace std;
+
+struct AspPricingOptions {
+  double scale = 1000.0;     // duals and costs are rounded to integers after scaling, as for duals_out.lp
+  unsigned bits = 24;        // binary digits of a scaled dual, larger ones saturate
+  vector<string> arguments;  // clingo options, e.g. "--parallel-mode=4"
+};
+
+/** prices all routes with pricing_multishot.lp and optional side constraint programs
+ *
+ *  The program and the instance facts are grounded once in init. Each round assigns the
+ *  dualBit/3 externals to the binary digits of the scaled duals and solves again; clingo keeps
+ *  the ground program and what it learned between the rounds. The packings of the optimal model
+ *  are costed and reduced again on the exact duals, only those below -tolerance are returned.
+ *
+ *  Duals are rounded and large ones saturate at 2^bits - 1, so a round can miss a packing that
+ *  improves only slightly and the pricer is not exact: column generation computes no bounds.
+ */
+class AspPricer : public RoutePricer {
+public:
+  AspPricer(const Instance &instance, const AspPricingOptions &options = AspPricingOptions());
+
+  /** loads and grounds the files, pricing_multishot.lp first; false with a message on errors */
+  bool init(const vector<string> &files, string &error);
+
+  /** false with clingo's message if a side constraint program fails to solve */
+  bool price(const double *coverDuals, bool farkas, const PricingOptions &options, vector<Packing> &columns,
+             vector<double> &redcosts, double &mostNegative, string &error) override;
+
+  bool exact() const override { return false; }
+
+  /** solves so far and externals assigned over all of them */
+  size_t solves() const { return _solves; }
+  size_t assignments() const { return _assignments; }
+
+private:
+  string facts() const;
+
+  /** assigns the externals and solves, the packed items of the optimal model per slot */
+  bool solve(const double *coverDuals, bool farkas, vector<vector<tuple<int, int>>> &items);
+
+  const Instance &_instance;
+  AspPricingOptions _options;
+  unsigned _bits = 0;
+  clingo::Control _control;
+  vector<int> _slotRoute;                 // route of every slot of instance.routeTR
+  vector<clingo::literal_t> _dualLiteral; // [rp * _bits + b], 0 if the external was not grounded
+  vector<char> _dualValue;                // last truth value assigned to each of them
+  clingo::literal_t _farkasLiteral = 0;
+  char _farkasValue = -1;
+  size_t _solves = 0;
+  size_t _assignments = 0;
+};
+
+#endif // LNO_ASP_PRICING_H
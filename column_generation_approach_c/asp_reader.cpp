@@ -0,0 +1,413 @@
+//
+// Reader for LNO instances given as ASP facts (factsASP.lp, optimised_instances.lp, ...).
+//
+
+#include "asp_reader.h"
+
+#include <algorithm>
+#include <charconv>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+const int MAX_ARITY = 5;
+
+/** a fact as views into the file: pred(args[0], ..., args[arity-1]). */
+struct Fact {
+  string_view pred;
+  string_view args[MAX_ARITY];
+  int arity = 0;
+};
+
+/** splits the mapped file into facts, skipping comments, directives and rules */
+class FactScanner {
+public:
+  FactScanner(const char *begin, const char *end) : _p(begin), _end(end){};
+
+  bool next(Fact &fact) {
+    while (skip_space()) {
+      if (*_p == '%') {
+        skip_comment();
+        continue;
+      }
+      if (!is_lower(*_p)) {
+        skip_statement();
+        continue;
+      }
+
+      const char *start = _p;
+      while (_p < _end && is_ident(*_p))
+        ++_p;
+      fact.pred = string_view(start, _p - start);
+      fact.arity = 0;
+
+      skip_space();
+      bool ok = true;
+      if (_p < _end && *_p == '(')
+        ok = arguments(fact);
+      skip_space();
+
+      if (ok && _p < _end && *_p == '.' && !(_p + 1 < _end && _p[1] == '.')) {
+        ++_p;
+        return true;
+      }
+      skip_statement();
+    }
+    return false;
+  };
+
+private:
+  static bool is_lower(char c) { return (c >= 'a' && c <= 'z') || c == '_'; }
+  static bool is_ident(char c) {
+    return is_lower(c) || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '\'';
+  }
+  static bool is_space(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+  /** returns false at the end of the input */
+  bool skip_space() {
+    while (_p < _end && is_space(*_p))
+      ++_p;
+    return _p < _end;
+  };
+
+  void skip_comment() {
+    if (_p + 1 < _end && _p[1] == '*') {
+      for (_p += 2; _p + 1 < _end && !(_p[0] == '*' && _p[1] == '%'); ++_p) {
+      }
+      _p = min(_p + 2, _end);
+    } else {
+      while (_p < _end && *_p != '\n')
+        ++_p;
+    }
+  };
+
+  void skip_quoted() {
+    for (++_p; _p < _end && *_p != '"'; ++_p)
+      if (*_p == '\\')
+        ++_p;
+    if (_p < _end)
+      ++_p;
+  };
+
+  /** skips to behind the '.' ending the current statement (not a '..' range) */
+  void skip_statement() {
+    int depth = 0;
+    while (_p < _end) {
+      char c = *_p;
+      if (c == '"') {
+        skip_quoted();
+        continue;
+      }
+      if (c == '%') {
+        skip_comment();
+        continue;
+      }
+      ++_p;
+      if (c == '(')
+        ++depth;
+      else if (c == ')')
+        --depth;
+      else if (c == '.' && depth <= 0) {
+        if (_p < _end && *_p == '.') {
+          ++_p;
+          continue;
+        }
+        return;
+      }
+    }
+  };
+
+  /** reads the top-level arguments of pred(...), _p is on the '(' */
+  bool arguments(Fact &fact) {
+    ++_p;
+    int depth = 0;
+    const char *start = _p;
+    while (_p < _end) {
+      char c = *_p;
+      if (c == '"') {
+        skip_quoted();
+        continue;
+      }
+      if (c == '(') {
+        ++depth;
+      } else if (c == ')' && depth > 0) {
+        --depth;
+      } else if ((c == ',' || c == ')') && depth == 0) {
+        if (fact.arity == MAX_ARITY)
+          return false;
+        fact.args[fact.arity++] = trim(string_view(start, _p - start));
+        ++_p;
+        if (c == ')')
+          return true;
+        start = _p;
+        continue;
+      }
+      ++_p;
+    }
+    return false;
+  };
+
+  static string_view trim(string_view s) {
+    while (!s.empty() && is_space(s.front()))
+      s.remove_prefix(1);
+    while (!s.empty() && is_space(s.back()))
+      s.remove_suffix(1);
+    return s;
+  };
+
+  const char *_p;
+  const char *_end;
+};
+
+/** removes surrounding quotes of a string constant */
+string_view sym(string_view s) {
+  if (s.size() >= 2 && (s.front() == '"' || s.front() == '\'') && s.back() == s.front())
+    return s.substr(1, s.size() - 2);
+  return s;
+}
+
+bool number(string_view s, double &value) {
+  auto result = from_chars(s.data(), s.data() + s.size(), value);
+  return result.ec == errc() && result.ptr == s.data() + s.size();
+}
+
+struct PairHash {
+  size_t operator()(const pair<const void *, const void *> &p) const {
+    return hash<const void *>()(p.first) * 31 + hash<const void *>()(p.second);
+  }
+};
+
+/** read-only mapping of a whole file */
+class MappedFile {
+public:
+  explicit MappedFile(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+      return;
+    struct stat st;
+    if (fstat(fd, &st) == 0) {
+      _size = (size_t)st.st_size;
+      if (_size == 0) {
+        _ok = true;
+      } else {
+        void *map = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED) {
+          madvise(map, _size, MADV_SEQUENTIAL);
+          _data = static_cast<const char *>(map);
+          _ok = true;
+        }
+      }
+    }
+    close(fd);
+  };
+
+  ~MappedFile() {
+    if (_data)
+      munmap(const_cast<char *>(_data), _size);
+  };
+
+  bool ok() const { return _ok; }
+  const char *begin() const { return _data; }
+  const char *end() const { return _data + _size; }
+
+private:
+  const char *_data = nullptr;
+  size_t _size = 0;
+  bool _ok = false;
+};
+
+} // namespace
+
+bool load_instance_asp(const char *path, const Settings &settings, Arena &arena,
+                       LoadedInstance &instance, string &error) {
+  MappedFile file(path);
+  if (!file.ok()) {
+    error = string("Cannot open file ") + path;
+    return false;
+  }
+
+  instance.settings = settings;
+  auto &locations = instance.locationKeys;
+  auto &transportResources = instance.transportResourceKeys;
+  auto &products = instance.productKeys;
+
+  // objects are keyed by name, the key is the arena copy of the name
+  auto location = [&](string_view name) {
+    auto it = locations.find(name);
+    if (it != locations.end())
+      return it->second;
+    auto *object = arena.make<Location>();
+    object->name.assign(name);
+    locations.emplace(object->name, object);
+    return object;
+  };
+  auto transportResource = [&](string_view name) {
+    auto it = transportResources.find(name);
+    if (it != transportResources.end())
+      return it->second;
+    auto *object = arena.make<TransportResource>();
+    object->name.assign(name);
+    object->speed = 1.0;
+    transportResources.emplace(object->name, object);
+    return object;
+  };
+  auto product = [&](string_view name) {
+    auto it = products.find(name);
+    if (it != products.end())
+      return it->second;
+    auto *object = arena.make<Product>();
+    object->name.assign(name);
+    products.emplace(object->name, object);
+    return object;
+  };
+
+  // attributes may precede or name undeclared objects, so they are applied at the end
+  enum Attribute { CAPACITY, CO2, COST, SPEED, SIZE, VALUE };
+  vector<tuple<Attribute, string_view, double>> attributes;
+  vector<pair<string_view, string_view>> partTR;
+  unordered_map<pair<const void *, const void *>, Route *, PairHash> routes;
+
+  Fact fact;
+  FactScanner scanner(file.begin(), file.end());
+  double q = 0;
+  while (scanner.next(fact)) {
+    const string_view pred = fact.pred;
+    const auto &a = fact.args;
+
+    switch (fact.arity) {
+    case 1:
+      if (pred == "location") location(sym(a[0]));
+      else if (pred == "transportResource") transportResource(sym(a[0]));
+      else if (pred == "part") product(sym(a[0]));
+      break;
+
+    case 2:
+      if (pred == "partTR") {
+        partTR.emplace_back(sym(a[0]), sym(a[1]));
+        break;
+      }
+      if (!number(a[1], q))
+        break;
+      if (pred == "transportCapacity") attributes.emplace_back(CAPACITY, sym(a[0]), q);
+      else if (pred == "transportCO2") attributes.emplace_back(CO2, sym(a[0]), q);
+      else if (pred == "transportCost") attributes.emplace_back(COST, sym(a[0]), q);
+      else if (pred == "transportSpeed") attributes.emplace_back(SPEED, sym(a[0]), q);
+      else if (pred == "partSize") attributes.emplace_back(SIZE, sym(a[0]), q);
+      else if (pred == "partVal") attributes.emplace_back(VALUE, sym(a[0]), q);
+      break;
+
+    case 3:
+      if ((pred == "offer" || pred == "demand" || pred == "demandOffer") && number(a[2], q)) {
+        int amount = (int)q;
+        if (pred == "demand")
+          amount = -amount;
+        product(sym(a[0]))->netSupplyDemand[location(sym(a[1]))] += amount;
+      }
+      break;
+
+    case 5:
+      if (pred == "route" && number(a[3], q)) {
+        Location *from = location(sym(a[0]));
+        Location *to = location(sym(a[1]));
+        TransportResource *tr = transportResource(sym(a[2]));
+
+        Route *&route = routes[{from, to}];
+        if (route == nullptr) {
+          route = arena.make<Route>();
+          route->from = from;
+          route->to = to;
+        }
+
+        // keep min distance per (from, to, tr)
+        auto entry = find_if(route->transportResources.begin(), route->transportResources.end(),
+                             [&](const auto &e) { return get<0>(e) == tr; });
+        if (entry == route->transportResources.end())
+          route->transportResources.emplace_back(tr, q);
+        else if (q < get<1>(*entry))
+          get<1>(*entry) = q;
+      }
+      break;
+
+    default:
+      break;
+    }
+  }
+
+  for (const auto &[attribute, name, v] : attributes) {
+    if (attribute <= SPEED) {
+      auto it = transportResources.find(name);
+      if (it == transportResources.end())
+        continue;
+      TransportResource *tr = it->second;
+      if (attribute == CAPACITY) tr->capacity = v;
+      else if (attribute == CO2) tr->co2Emissions = v;
+      else if (attribute == COST) tr->cost = v;
+      else tr->speed = v;
+    } else {
+      auto it = products.find(name);
+      if (it == products.end())
+        continue;
+      if (attribute == SIZE) it->second->size = v;
+      else it->second->value = v;
+    }
+  }
+
+  for (const auto &[productName, trName] : partTR) {
+    auto p = products.find(productName);
+    auto t = transportResources.find(trName);
+    if (p == products.end() || t == transportResources.end())
+      continue;
+    auto &valid = p->second->validTR;
+    if (find(valid.begin(), valid.end(), t->second) == valid.end())
+      valid.push_back(t->second);
+  }
+
+  // deterministic order: by name, routes by (from, to)
+  auto byName = [](const auto *a, const auto *b) { return a->name < b->name; };
+  instance.locations.clear();
+  for (const auto &entry : locations)
+    instance.locations.push_back(entry.second);
+  sort(instance.locations.begin(), instance.locations.end(), byName);
+
+  instance.transportResources.clear();
+  for (const auto &entry : transportResources)
+    instance.transportResources.push_back(entry.second);
+  sort(instance.transportResources.begin(), instance.transportResources.end(), byName);
+
+  instance.products.clear();
+  for (const auto &entry : products) {
+    auto &valid = entry.second->validTR;
+    sort(valid.begin(), valid.end(), byName);
+    instance.products.push_back(entry.second);
+  }
+  sort(instance.products.begin(), instance.products.end(), byName);
+
+  instance.routes.clear();
+  for (const auto &entry : routes)
+    instance.routes.push_back(entry.second);
+  sort(instance.routes.begin(), instance.routes.end(), [](const Route *a, const Route *b) {
+    return a->from->name != b->from->name ? a->from->name < b->from->name
+                                          : a->to->name < b->to->name;
+  });
+
+  instance.routeKeys.clear();
+  for (auto *route : instance.routes) {
+    sort(route->transportResources.begin(), route->transportResources.end(),
+         [](const auto &a, const auto &b) { return get<0>(a)->name < get<0>(b)->name; });
+
+    pmr::string key(route->from->name, arena.resource());
+    key += "->";
+    key += route->to->name;
+    instance.routeKeys.emplace(arena.intern(key), route);
+  }
+
+  return true;
+}
@@ -0,0 +1,31 @@
+//
+// Reader for LNO instances given as ASP facts (factsASP.lp, optimised_instances.lp, ...).
+//
+
+#ifndef LNO_ASP_READER_H
+#define LNO_ASP_READER_H
+
+#include <string>
+
+#include "arena.h"
+#include "instance_loader.h"
+#include "main.h"
+
+using namespace std;
+
+/** memory-maps an ASP fact file and builds the domain objects from its facts
+ *
+ *  Understood facts: location/1, transportResource/1, transportCapacity/2, transportCO2/2,
+ *  transportCost/2, transportSpeed/2, part/1, partSize/2, partVal/2, partTR/2, offer/3,
+ *  demand/3, demandOffer/3 (signed net supply) and route/5. Everything else, including rules,
+ *  is skipped. As in controller.py::facts_to_json, routes are grouped by (from, to) keeping the
+ *  minimum distance per transport resource, and partTR facts naming undeclared products or
+ *  transport resources are ignored.
+ *
+ *  Objects are ordered by name, routes by (from, to); route keys are "from->to". Tokens are views
+ *  into the mapping, only names of new objects are copied (into the arena).
+ */
+bool load_instance_asp(const char *path, const Settings &settings, Arena &arena,
+                       LoadedInstance &instance, string &error);
+
+#endif // LNO_ASP_READER_H
@@ -0,0 +1,147 @@
+#include "batch.h"
+#include <condition_variable>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include "rmp_core.h"
+#include "dual_io.h"
+#include "instance_loader.h"
+#include "asp_reader.h"
+#include "presolve.h"
+#include "greedy_start.h"
+#include "thread_pool.h"
+using namespace scip;
+
+namespace {
+
+struct Job {
+  size_t index = 0;
+  std::string input;   // json text or path
+  std::string name;
+  std::string result;  // everything printed for the job
+  bool ok = false;
+};
+
+bool ends_with(const std::string& s, const char* suffix)
+{
+  const size_t n = std::char_traits<char>::length(suffix);
+  return s.size() >= n && s.compare(s.size()-n, n, suffix) == 0;
+}
+
+bool load_job(const Job& job, bool manifest, Arena& arena, LoadedInstance& li, std::string& error)
+{
+  if (!manifest) return load_instance_json(std::string_view(job.input), arena, li, error);
+  if (ends_with(job.input, ".lp")) return load_instance_asp(job.input.c_str(), FACT_FORMAT_SETTINGS, arena, li, error);
+  std::ifstream in(job.input);
+  if (!in) { error = "Cannot open " + job.input; return false; }
+  return load_instance_json(in, arena, li, error);
+}
+
+void solve_job(Job& job, const BatchOptions& options)
+{
+  std::ostringstream out;
+  out << "RESULT " << job.index << " " << job.name;
+
+  Arena arena;
+  LoadedInstance li;
+  std::string error;
+  if (!load_job(job, options.manifest, arena, li, error)) {
+    job.result = out.str() + " ERROR " + error + "\nEND " + std::to_string(job.index) + "\n";
+    return;
+  }
+
+  Instance instance = build_instance(li.settings, li.locations, li.transportResources, li.products, li.routes);
+  if (options.presolve) presolve_instance(instance);
+  RmpSession session(instance);
+  std::ostringstream body;
+  bool ok = session.init(options.cg && options.options.stabilization.boxStep, !(options.cg && options.options.farkas)) == SCIP_OKAY;
+  if (ok && options.cg) {
+    if (options.greedy) {
+      TransportPlan greedy;
+      greedy_plan(instance, greedy);
+      ok = seed_columns(session, greedy) == SCIP_OKAY;
+    }
+    ColumnGenerationResult result;
+    ColumnGenerationOptions cgOptions = options.options;
+    cgOptions.stats = nullptr;     // Stats is single threaded
+    cgOptions.stabilization.log = nullptr;
+    WorkStealingPool pricingPool(cgOptions.pricing.threads == 0 ? 1 : cgOptions.pricing.threads);
+    ok = ok && run_column_generation(session, cgOptions, pricingPool, result) == SCIP_OKAY;
+    if (ok && session.optimal())
+      body << "CG OBJ " << result.objective << " ROUNDS " << result.rounds << " COLUMNS " << result.columns
+           << " ITER " << result.lpIterations << "\n";
+  } else if (ok) {
+    ok = session.solve() == SCIP_OKAY;
+  }
+
+  if (!ok || !session.optimal()) {
+    job.result = out.str() + (ok ? " ERROR infeasible" : " ERROR solver failed") + "\nEND " + std::to_string(job.index) + "\n";
+    return;
+  }
+
+  if (options.binaryDuals) ok = write_duals_binary(body, session) == SCIP_OKAY;
+  else session.print_duals(body);
+
+  // a binary body is framed by its length, readers take exactly that many bytes before END
+  const std::string text = body.str();
+  if (!ok) out << " ERROR writing duals\n";
+  else if (options.binaryDuals) out << " OK " << text.size() << "\n" << text;
+  else out << " OK\n" << text << (text.empty() || text.back()=='\n' ? "" : "\n");
+  out << "END " << job.index << "\n";
+  job.result = out.str();
+  job.ok = ok;
+}
+
+} // namespace
+
+size_t run_batch(std::istream& in, std::ostream& out, const BatchOptions& options)
+{
+  WorkStealingPool workers(options.workers);
+  // jobs read but not yet written: a slow job holds back the output, not the other workers,
+  // until the others are this far ahead of it
+  const size_t window = 4*workers.size();
+
+  std::mutex lock;
+  std::condition_variable progress;
+  size_t failed = 0, index = 0, written = 0, lineNo = 0;
+  bool more = true;
+  std::map<size_t, Job> finished;  // reorder buffer, results leave in input order
+
+  // every worker reads its next job as soon as it is free
+  workers.parallel_for(workers.size(), [&](size_t) {
+    for (;;) {
+      Job job;
+      {
+        std::unique_lock<std::mutex> guard(lock);
+        progress.wait(guard, [&] { return !more || index - written < window; });
+        std::string line;
+        while (more && (more = (bool)std::getline(in, line))) {
+          ++lineNo;
+          if (line.find_first_not_of(" \t\r") != std::string::npos) break;
+        }
+        if (!more) { progress.notify_all(); return; }
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        job.index = index++;
+        job.name = options.manifest ? line : "#" + std::to_string(lineNo);
+        job.input = std::move(line);
+      }
+
+      solve_job(job, options);
+
+      {
+        std::lock_guard<std::mutex> guard(lock);
+        finished.emplace(job.index, std::move(job));
+        for (auto it = finished.begin(); it != finished.end() && it->first == written; it = finished.erase(it)) {
+          out << it->second.result;
+          if (!it->second.ok) ++failed;
+          ++written;
+        }
+        out.flush();
+      }
+      progress.notify_all();
+    }
+  });
+  return failed;
+}
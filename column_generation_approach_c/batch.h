@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include "column_generation.h"
+
+// Many instances per process: jobs are read from the input, solved concurrently (every job
+// has its own arena, instance and LP) and their results are written in input order.
+struct BatchOptions {
+  size_t workers = 0;          // concurrent jobs, 0 = one per hardware thread
+  bool   manifest = false;     // input lines are instance paths (.lp facts or json) instead of json
+  bool   cg = false;           // column generation instead of a single RMP solve
+  bool   presolve = false;     // presolve_instance before building the RMP, reductions are not reported
+  bool   greedy = false;       // seed the column generation RMP with the greedy_plan packings
+  bool   binaryDuals = false;  // duals as binary block (dual_io.h) instead of text
+  ColumnGenerationOptions options;  // pricing.threads is per job, keep it at 1 for wide batches
+};
+
+// Reads one job per non-empty line and writes for every job, in input order,
+//   RESULT <index> <name> OK            (name: the path, or #<line> for inline json)
+//   <output of the one-shot mode: [CG line] duals>
+//   END <index>
+// With binaryDuals the header is "RESULT <index> <name> OK <bytes>" and exactly <bytes> bytes
+// ([CG line] and the dual block) follow before END.
+// or "RESULT <index> <name> ERROR <message>" followed by END. A worker reads its next job as
+// soon as it is free, at most a few per worker ahead of the oldest unwritten result, so the
+// whole stream is never held in memory and one slow job does not idle the others. Returns the
+// number of failed jobs.
+size_t run_batch(std::istream& in, std::ostream& out, const BatchOptions& options);
@@ -0,0 +1,270 @@
+#include "column_generation.h"
+#include "stats.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <vector>
+using namespace scip;
+
+namespace {
+
+// appends the wall time of its scope to result.pricingSeconds
+struct PricingTimer {
+  std::chrono::steady_clock::time_point start; std::vector<double>& out;
+  ~PricingTimer() { out.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()); }
+};
+
+// reduced cost of a packing on the given cover duals ([rp])
+double reduced_cost(const Instance& inst, const Packing& packing, const double* cover)
+{
+  double rc = packing.cost;
+  for (const auto& item: packing.items)
+    rc -= std::get<1>(item) * cover[inst.rp(packing.route, std::get<0>(item))];
+  return rc;
+}
+
+// the knapsacks, or the pricer of the options if one is set; its errors go to result.error
+double price_all(const Instance& inst, const double* duals, bool farkas, const PricingOptions& options,
+                 RoutePricer* pricer, WorkStealingPool& pool, ColumnGenerationResult& result,
+                 std::vector<Packing>& columns, std::vector<double>& redcosts)
+{
+  if (!pricer) return price_routes(inst, duals, farkas, options, pool, columns, redcosts);
+  double mostNegative = 0.0;
+  std::string error;
+  if (!pricer->price(duals, farkas, options, columns, redcosts, mostNegative, error)) {
+    result.error = "pricing failed: " + error;
+    columns.clear(); redcosts.clear();
+  }
+  return mostNegative;
+}
+
+// Prices at sep and keeps the columns improving the RMP duals rmp: pool first, knapsacks only
+// if the pool has nothing. best (if given) receives the best reduced cost per route at sep,
+// returns false if the knapsacks were not solved for every route (no bound this round) or the
+// pricer is not exact.
+bool price_columns(const Instance& inst, const double* sep, const double* rmp, const PricingOptions& options,
+                   RoutePricer* pricer, WorkStealingPool& pool, ColumnPool* columnPool, ColumnGenerationResult& result,
+                   std::vector<Packing>& columns, std::vector<double>& redcosts,
+                   std::vector<double>* best = nullptr)
+{
+  auto keepImproving = [&]() {
+    if (sep == rmp) return;
+    size_t n = 0;
+    for (size_t i=0; i<columns.size(); ++i) {
+      const double rc = reduced_cost(inst, columns[i], rmp);
+      if (rc < -options.tolerance) { columns[n] = std::move(columns[i]); redcosts[n++] = rc; }
+    }
+    columns.resize(n); redcosts.resize(n);
+  };
+
+  PricingTimer timer{std::chrono::steady_clock::now(), result.pricingSeconds};
+
+  columns.clear(); redcosts.clear();
+  if (columnPool) {
+    columnPool->price(sep, false, options, pool, columns, redcosts);
+    keepImproving();
+    if (!columns.empty()) { ++result.poolRounds; return false; }
+  }
+
+  columns.clear(); redcosts.clear();
+  result.bestRedcost = price_all(inst, sep, false, options, pricer, pool, result, columns, redcosts);
+  ++result.pricerRounds;
+  if (columnPool) for (const auto& packing: columns) columnPool->insert(packing);
+  if (best) *best = best_per_route(inst, columns, redcosts);
+  keepImproving();
+  return options.maxColumns == 0 && (!pricer || pricer->exact());
+}
+
+// Farkas pricing: the packings that cover sum units * multiplier > 0 on the proof of an
+// infeasible RMP, pool first as above; their reduced costs are -coverage
+void price_farkas(const Instance& inst, const double* farkas, const PricingOptions& options,
+                  RoutePricer* pricer, WorkStealingPool& pool, ColumnPool* columnPool, ColumnGenerationResult& result,
+                  std::vector<Packing>& columns, std::vector<double>& redcosts)
+{
+  PricingTimer timer{std::chrono::steady_clock::now(), result.pricingSeconds};
+
+  columns.clear(); redcosts.clear();
+  if (columnPool) {
+    columnPool->price(farkas, true, options, pool, columns, redcosts);
+    if (!columns.empty()) { ++result.poolRounds; return; }
+  }
+  price_all(inst, farkas, true, options, pricer, pool, result, columns, redcosts);
+  ++result.pricerRounds;
+  if (columnPool) for (const auto& packing: columns) columnPool->insert(packing);
+}
+
+} // namespace
+
+SCIP_RETCODE run_column_generation(RmpSession& session, const ColumnGenerationOptions& options,
+                                   WorkStealingPool& pool, ColumnGenerationResult& result,
+                                   ColumnPool* columnPool)
+{
+  const Instance& inst = session.instance();
+  const StabilizationOptions& stab = options.stabilization;
+  const PricingOptions& pricing = options.pricing;
+  Stats* stats = options.stats;
+  const size_t LP = inst.L*inst.P, RP = inst.R*inst.P;
+
+  result = ColumnGenerationResult();
+  result.lowerBound = -std::numeric_limits<double>::infinity();
+  std::vector<Packing> columns;
+  std::vector<double> redcosts;
+
+  // Lagrangian bound L(pi) = sum nsd*phi + kappa * sum_r min(0, best reduced cost on r):
+  // phi stays dual feasible for the f columns under smoothing, kappa bounds the trips per route
+  double kappa = stab.tripBound;
+  if (kappa <= 0) for (int nsd: inst.netSupplyDemand) kappa += std::max(nsd, 0);
+
+  // without smoothing alpha stays 0, so the separation point is the RMP dual solution
+  double alpha = stab.smoothing ? stab.alpha : 0.0;
+  double boxWidth = stab.boxWidth;
+  std::vector<double> center, sep(LP+RP);  // full dual vectors [flow | cover]
+  std::vector<double> caps(RP);
+  ConvergenceMonitor monitor(options.convergence);
+
+  while (options.maxRounds == 0 || result.rounds < options.maxRounds) {
+    {
+      ScopedTimer timer(stats, "rmp_solve");
+      SCIP_CALL( session.solve() );
+    }
+    ++result.rounds;
+    result.lpIterations += session.iterations();
+
+    if (session.infeasible()) {
+      {
+        ScopedTimer timer(stats, "pricing_farkas");
+        price_farkas(inst, session.cover_farkas(), pricing, options.pricer, pool, columnPool, result, columns, redcosts);
+      }
+      if (!result.error.empty()) return SCIP_ERROR;
+      ++result.farkasRounds;
+      for (const auto& packing : columns) {
+        ScopedTimer timer(stats, "add_column");
+        SCIP_CALL( session.add_column(packing) );
+      }
+      result.columns += columns.size();
+      if (stats) {
+        Stats::Round round;
+        round.round = result.rounds;
+        round.wall = stats->wall(); round.cpu = stats->cpu();
+        round.primalBound = std::numeric_limits<double>::infinity();
+        round.dualBound = result.lowerBound;
+        round.lpIterations = session.iterations();
+        round.columnsAdded = columns.size(); round.columnsTotal = result.columns;
+        round.pricingSeconds = result.pricingSeconds.back();
+        stats->round(round);
+        stats->count("columns_added", (long)columns.size());
+        stats->count("lp_iterations", session.iterations());
+        stats->count("farkas_rounds");
+      }
+      // no packing destroys the proof: the instance itself is infeasible
+      if (columns.empty()) return SCIP_OKAY;
+      continue;
+    }
+    if (!session.optimal()) return SCIP_OKAY;
+    result.objective = session.objective();
+
+    const std::vector<double>& out = session.duals();
+    if (center.empty()) center = out;
+    const size_t pricingCalls = result.pricingSeconds.size();
+
+    // mispricing schedule: alpha_k = 1 - k(1 - alpha) until a column improves the RMP duals
+    bool moved = false;
+    size_t misprice = 0;
+    double alphaK = alpha, bound = result.lowerBound;
+    std::vector<double> best;
+    for (;;) {
+      for (size_t i=0; i<LP+RP; ++i) sep[i] = alphaK*center[i] + (1-alphaK)*out[i];
+
+      {
+        ScopedTimer timer(stats, "pricing");
+        if (price_columns(inst, sep.data()+LP, session.cover_duals(), pricing, options.pricer, pool, columnPool,
+                          result, columns, redcosts, &best)) {
+          bound = 0.0;
+          for (size_t i=0; i<LP; ++i) bound += inst.netSupplyDemand[i]*sep[i];
+          for (double b: best) bound += kappa*b;
+          if (bound > result.lowerBound) { result.lowerBound = bound; center = sep; moved = true; }
+          // at the RMP duals themselves, also Farley's bound
+          if (alphaK == 0.0) result.lowerBound = std::max(result.lowerBound, farley_bound(inst, best, result.objective));
+        }
+      }
+      if (!result.error.empty()) return SCIP_ERROR;
+      if (!columns.empty() || alphaK <= 0.0) break;
+
+      ++misprice; ++result.mispricings;
+      alphaK = std::max(0.0, 1.0 - (misprice+1)*(1.0-alpha));
+    }
+
+    // direction test: the subgradient at sep points towards the RMP duals -> trust them more
+    if (stab.smoothing && stab.autoAlpha && misprice == 0) {
+      std::vector<double> g(RP);
+      for (size_t r=0; r<inst.R; ++r) for (size_t p=0; p<inst.P; ++p)
+        g[inst.rp(r,p)] = session.flow_value(r,p) - session.big_m_value(r,p);
+      for (const auto& packing: columns)
+        for (const auto& item: packing.items)
+          g[inst.rp(packing.route, std::get<0>(item))] -= kappa*std::get<1>(item);
+      double dot = 0.0;
+      for (size_t i=0; i<RP; ++i) dot += g[i]*(out[LP+i] - center[LP+i]);
+      alpha = dot > 0 ? std::max(0.0, alpha-0.1) : std::min(0.9, alpha+0.1);
+    } else if (misprice > 0) {
+      alpha = std::max(0.0, alpha-0.1);
+    }
+
+    if (stab.log)
+      *stab.log << "stab round " << result.rounds << " obj " << result.objective << " lb " << bound
+                << " alpha " << alphaK << " next " << alpha << " misprice " << misprice
+                << (moved ? " center moved" : "") << "\n";
+
+    // a binding cap means the RMP value is not the true one yet, so no early stop then
+    monitor.record(result.objective, result.lowerBound);
+    result.gap = monitor.gap();
+    const bool capped = stab.boxStep && session.cover_dual_caps_active();
+    bool done = false;
+    if (!columns.empty() && !capped && monitor.stop()) {
+      result.gapClosed = monitor.gap_closed();
+      result.tailingOff = !result.gapClosed;
+      if (stats) stats->count(result.gapClosed ? "gap_closed" : "tailing_off");
+      columns.clear();
+      done = true;
+    }
+    else if (columns.empty()) {
+      // no column improves, but a binding cap means the RMP value is not the true one yet
+      if (capped) {
+        boxWidth *= 10;
+        if (stab.log) *stab.log << "stab box binding, width " << boxWidth << "\n";
+      } else {
+        result.optimal = done = true;
+        // no improving column: the RMP value is the LP bound
+        result.lowerBound = std::max(result.lowerBound, result.objective);
+        result.gap = 0.0;
+      }
+    }
+
+    for (const auto& packing : columns) {
+      ScopedTimer timer(stats, "add_column");
+      SCIP_CALL( session.add_column(packing) );
+    }
+    result.columns += columns.size();
+
+    if (stats) {
+      Stats::Round round;
+      round.round = result.rounds;
+      round.wall = stats->wall(); round.cpu = stats->cpu();
+      round.primalBound = result.objective; round.dualBound = result.lowerBound;
+      round.lpIterations = session.iterations();
+      round.columnsAdded = columns.size(); round.columnsTotal = result.columns;
+      for (size_t i=pricingCalls; i<result.pricingSeconds.size(); ++i) round.pricingSeconds += result.pricingSeconds[i];
+      stats->round(round);
+      stats->count("columns_added", (long)columns.size());
+      stats->count("lp_iterations", session.iterations());
+      stats->count("mispricings", (long)misprice);
+    }
+    if (done) return SCIP_OKAY;
+
+    if (stab.boxStep) {
+      for (size_t i=0; i<RP; ++i) caps[i] = center[LP+i] + boxWidth;
+      SCIP_CALL( session.set_cover_dual_caps(caps) );
+    }
+  }
+  return SCIP_OKAY;
+}
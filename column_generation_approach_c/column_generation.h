@@ -0,0 +1,70 @@
+#pragma once
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "rmp_core.h"
+#include "pricing.h"
+#include "column_pool.h"
+#include "convergence.h"
+#include "stats.h"
+
+// Dual stabilization of the pricing duals. The Big-M y columns make the early cover duals
+// jump between 0 and 1e6, so pricing on the raw RMP duals produces many useless columns.
+struct StabilizationOptions {
+  bool   smoothing = false;  // Wentges: price at alpha*center + (1-alpha)*RMP duals
+  double alpha = 0.5;        // initial weight of the stability center
+  bool   autoAlpha = true;   // adapt alpha from the subgradient at the separation point
+  bool   boxStep = false;    // cap the cover duals at center + boxWidth (session needs init(true))
+  double boxWidth = 1e3;     // grows 10x whenever a cap is still binding at the end
+  double tripBound = 0.0;    // trips per route in the Lagrangian bound, 0 = total supply
+  std::ostream* log = nullptr; // one line per round: alpha, mispricings, bound, center moves
+};
+
+struct ColumnGenerationOptions {
+  PricingOptions pricing;
+  RoutePricer* pricer = nullptr; // prices instead of the knapsacks, e.g. AspPricer (asp_pricing.h)
+  StabilizationOptions stabilization;
+  ConvergenceOptions convergence;  // gap and tailing-off stop on top of pricing's own optimality
+  size_t maxRounds = 0;      // 0 = no limit
+  bool   farkas = false;     // the session is built without Big-M y: init(boxStep, !farkas)
+  Stats* stats = nullptr;    // timers for rmp_solve, pricing, add_column and one record per round
+};
+
+struct ColumnGenerationResult {
+  bool   optimal = false;   // pricing found no improving column
+  double objective = 0.0;   // RMP objective of the last solve
+  double bestRedcost = 0.0; // most negative reduced cost of the last pricing round
+  double lowerBound = 0.0;  // best Lagrangian or Farley bound seen, the LP value once optimal
+  double gap = 0.0;         // relative gap between objective and lowerBound when stopping
+  bool   gapClosed = false; // stopped early: the gap fell below options.convergence.gap
+  bool   tailingOff = false; // stopped early: the RMP value stalled over convergence.tailingRounds
+  size_t rounds = 0;        // solve + price rounds
+  size_t columns = 0;       // packing columns added
+  size_t poolRounds = 0;    // rounds served from the column pool without calling the pricer
+  size_t pricerRounds = 0;  // rounds that solved the knapsacks
+  size_t mispricings = 0;   // stabilized pricing rounds without a column improving the RMP
+  size_t farkasRounds = 0;  // rounds priced on a Farkas proof of an infeasible RMP
+  long   lpIterations = 0;  // simplex pivots over all solves
+  std::vector<double> pricingSeconds; // wall time of every pricing call (pool and knapsacks)
+  std::string error;        // why options.pricer failed, run_column_generation then returns SCIP_ERROR
+};
+
+// Column generation on a session without SCIP's branch-and-price loop: solve the RMP,
+// price all routes in parallel on the pool, append the improving packings, repeat.
+// Stops when a round adds nothing or after maxRounds. Returns SCIP_OKAY with
+// result.optimal false if the RMP turns infeasible.
+// Each complete pricing round at the RMP duals also yields the Farley bound (convergence.h);
+// with options.convergence set, the loop stops early once the gap to the best bound is closed
+// or the RMP value tails off. The session then holds the last, still optimal, RMP and
+// result.optimal stays false.
+// With a column pool, each round first prices the pooled patterns and only calls the
+// knapsack pricer if none of them improves; the pricer's columns are added to the pool.
+// With stabilization, columns are priced at the smoothed duals and kept if they improve
+// the RMP; a round without one is a mispricing and is repeated closer to the RMP duals.
+// A session built without Big-M columns starts infeasible: while it is, each round prices on the
+// Farkas proof instead, until the packings cover a feasible flow. If no packing destroys the
+// proof the instance is infeasible and result.optimal stays false.
+scip::SCIP_RETCODE run_column_generation(RmpSession& session, const ColumnGenerationOptions& options,
+                                         WorkStealingPool& pool, ColumnGenerationResult& result,
+                                         ColumnPool* columnPool = nullptr);
@@ -0,0 +1,202 @@
+//
+// Pool of packing patterns shared between pricing rounds and runs.
+//
+
+#include "column_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string_view>
+
+using namespace std;
+
+ColumnPool::ColumnPool(const Instance &instance) : _instance(instance), _byTR(instance.T) {}
+
+uint64_t ColumnPool::pattern_hash(int transportResource, const vector<tuple<int, int>> &items) {
+  // FNV-1a over the canonical (sorted) form
+  uint64_t h = 14695981039346656037ull;
+  auto mix = [&h](uint64_t v) {
+    for (int i = 0; i < 8; ++i, v >>= 8) {
+      h ^= v & 0xff;
+      h *= 1099511628211ull;
+    }
+  };
+  mix((uint64_t)transportResource);
+  for (const auto &[product, units] : items) {
+    mix((uint64_t)product);
+    mix((uint64_t)units);
+  }
+  return h;
+}
+
+bool ColumnPool::fits(int transportResource, const vector<tuple<int, int>> &items) const {
+  // same integer sizes as the knapsack in price_packing
+  const int capacity = (int)floor(_instance.trCapacity[transportResource] + 1e-9);
+  long used = 0;
+  for (const auto &[product, units] : items) {
+    if (!_instance.valid(product, transportResource))
+      return false;
+    used += (long)ceil(_instance.productSize[product] - 1e-9) * units;
+  }
+  return used <= capacity;
+}
+
+bool ColumnPool::insert(const Packing &packing) {
+  return insert(packing.transportResource, packing.items);
+}
+
+bool ColumnPool::insert(int transportResource, vector<tuple<int, int>> items) {
+  items.erase(remove_if(items.begin(), items.end(), [](const auto &i) { return get<1>(i) <= 0; }),
+              items.end());
+  if (items.empty())
+    return false;
+  sort(items.begin(), items.end());
+
+  // merge repeated products, e.g. from a saved pool listing one unit per entry
+  size_t n = 0;
+  for (size_t i = 0; i < items.size(); ++i) {
+    if (n > 0 && get<0>(items[n - 1]) == get<0>(items[i]))
+      get<1>(items[n - 1]) += get<1>(items[i]);
+    else
+      items[n++] = items[i];
+  }
+  items.resize(n);
+
+  const uint64_t h = pattern_hash(transportResource, items);
+  auto range = _index.equal_range(h);
+  for (auto it = range.first; it != range.second; ++it) {
+    const Pattern &other = _patterns[it->second];
+    if (other.transportResource == transportResource && other.items == items)
+      return false;
+  }
+
+  _index.emplace(h, _patterns.size());
+  _byTR[transportResource].push_back(_patterns.size());
+  _patterns.push_back(Pattern{transportResource, std::move(items), h});
+  return true;
+}
+
+double ColumnPool::price(const double *coverDuals, bool farkas, const PricingOptions &options,
+                         WorkStealingPool &pool, vector<Packing> &columns,
+                         vector<double> &redcosts) const {
+  const Instance &instance = _instance;
+  vector<vector<Packing>> found(instance.R);
+  vector<vector<double>> foundRedcosts(instance.R);
+  vector<double> best(instance.R, 0.0);
+  atomic<size_t> nFound(0);
+  auto enough = [&]() { return options.maxColumns > 0 && nFound.load(memory_order_relaxed) >= options.maxColumns; };
+
+  pool.parallel_for(instance.R, [&](size_t r) {
+    if (enough())
+      return;
+    const double *duals = coverDuals + instance.rp(r, 0);
+
+    for (size_t k = instance.routeTRStart[r]; k < instance.routeTRStart[r + 1]; ++k) {
+      const int tr = instance.routeTR[k];
+      const double distance = instance.routeDistance[k];
+      if (!instance.enabled(r, tr))
+        continue;
+
+      for (size_t i : _byTR[tr]) {
+        if (enough())
+          return;
+        const Pattern &pattern = _patterns[i];
+        double covered = 0;
+        for (const auto &[product, units] : pattern.items)
+          covered += units * duals[product];
+        if (covered <= options.tolerance)
+          continue;
+
+        const double cost = packing_cost(instance, tr, distance, pattern.items);
+        const double redcost = (farkas ? 0 : cost) - covered;
+        best[r] = min(best[r], redcost);
+        if (redcost < -options.tolerance) {
+          found[r].push_back(Packing{(int)r, tr, distance, pattern.items, cost});
+          foundRedcosts[r].push_back(redcost);
+          nFound.fetch_add(1, memory_order_relaxed);
+        }
+      }
+    }
+  });
+
+  size_t added = 0;
+  for (size_t r = 0; r < instance.R; ++r) {
+    for (size_t i = 0; i < found[r].size(); ++i) {
+      if (options.maxColumns > 0 && added == options.maxColumns)
+        break;
+      columns.push_back(std::move(found[r][i]));
+      redcosts.push_back(foundRedcosts[r][i]);
+      ++added;
+    }
+  }
+
+  double mostNegative = 0.0;
+  for (double b : best)
+    mostNegative = min(mostNegative, b);
+  return mostNegative;
+}
+
+bool ColumnPool::save(const string &path) const {
+  ofstream out(path);
+  if (!out)
+    return false;
+
+  for (const Pattern &pattern : _patterns) {
+    out << escape_name(_instance.transportResources[pattern.transportResource]->name);
+    for (const auto &[product, units] : pattern.items)
+      out << ' ' << escape_name(_instance.products[product]->name) << '=' << units;
+    out << '\n';
+  }
+  return (bool)out;
+}
+
+bool ColumnPool::load(const string &path, string &error, size_t *skipped) {
+  ifstream in(path);
+  if (!in) {
+    error = "Cannot open column pool " + path;
+    return false;
+  }
+
+  // by escaped name, the form save writes
+  unordered_map<string, int> trIds, productIds;
+  for (const auto *tr : _instance.transportResources)
+    trIds.emplace(escape_name(tr->name), tr->id);
+  for (const auto *product : _instance.products)
+    productIds.emplace(escape_name(product->name), product->id);
+
+  size_t nSkipped = 0;
+  string line, trName, item;
+  while (getline(in, line)) {
+    istringstream fields(line);
+    if (!(fields >> trName))
+      continue;
+
+    auto tr = trIds.find(trName);
+    bool known = tr != trIds.end();
+    vector<tuple<int, int>> items;
+    while (known && fields >> item) {
+      auto eq = item.rfind('=');
+      auto product = eq == string::npos ? productIds.end()
+                                        : productIds.find(item.substr(0, eq));
+      if (product == productIds.end()) {
+        known = false;
+        break;
+      }
+      items.emplace_back(product->second, atoi(item.c_str() + eq + 1));
+    }
+
+    if (!known || !fits(tr->second, items)) {
+      ++nSkipped;
+      continue;
+    }
+    insert(tr->second, std::move(items));
+  }
+
+  if (skipped)
+    *skipped = nSkipped;
+  return true;
+}
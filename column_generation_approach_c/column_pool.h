@@ -0,0 +1,71 @@
+//
+// Pool of packing patterns shared between pricing rounds and runs.
+//
+
+#ifndef LNO_COLUMN_POOL_H
+#define LNO_COLUMN_POOL_H
+
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "instance.h"
+#include "packing.h"
+#include "thread_pool.h"
+
+using namespace std;
+
+/** a packing pattern without its route: which products one trip of a transport resource carries */
+struct Pattern {
+  int transportResource;
+  vector<tuple<int, int>> items; // (product, units), sorted by product, units > 0
+  uint64_t hash;
+};
+
+/** deduplicated set of packing patterns
+ *
+ *  Patterns are keyed by a canonical hash of (transport resource, product counts), so a
+ *  packing found on one route is stored once and offered on every route served by its
+ *  transport resource. The pool is saved with names rather than ids, loading it against
+ *  a different instance keeps the patterns whose transport resource and products exist,
+ *  are valid for each other and still fit the capacity.
+ */
+class ColumnPool {
+public:
+  explicit ColumnPool(const Instance &instance);
+
+  /** adds the pattern of a packing, returns false if it was already pooled or is empty */
+  bool insert(const Packing &packing);
+  bool insert(int transportResource, vector<tuple<int, int>> items);
+
+  size_t size() const { return _patterns.size(); }
+  const vector<Pattern> &patterns() const { return _patterns; }
+
+  /** prices every pooled pattern on every route its transport resource serves
+   *
+   *  Same contract as price_routes: coverDuals[instance.rp(r, p)], improving packings are
+   *  appended in route order, the most negative reduced cost is returned. With
+   *  options.maxColumns the routes stop once that many improving packings are found.
+   */
+  double price(const double *coverDuals, bool farkas, const PricingOptions &options,
+               WorkStealingPool &pool, vector<Packing> &columns, vector<double> &redcosts) const;
+
+  /** writes one line "<transportResource> <product>=<units> ..." per pattern, names as escape_name */
+  bool save(const string &path) const;
+
+  /** adds the patterns of a saved pool, counting the ones that do not fit this instance */
+  bool load(const string &path, string &error, size_t *skipped = nullptr);
+
+private:
+  static uint64_t pattern_hash(int transportResource, const vector<tuple<int, int>> &items);
+  bool fits(int transportResource, const vector<tuple<int, int>> &items) const;
+
+  const Instance &_instance;
+  vector<Pattern> _patterns;
+  vector<vector<size_t>> _byTR;                 // transport resource -> pattern indices
+  unordered_multimap<uint64_t, size_t> _index; // hash -> pattern indices
+};
+
+#endif // LNO_COLUMN_POOL_H
@@ -1,6 +1,11 @@
-import re, json, subprocess, sys
+import re, json, subprocess, sys, struct, mmap
 from collections import defaultdict
 
+try:
+    import lno_core  # in-process RMP core, built from python_bindings.cpp
+except ImportError:
+    lno_core = None
+
 FACT = re.compile(r'^\s*([a-zA-Z_][a-zA-Z0-9_]*)\((.*?)\)\.\s*$')
 
 def parse_terms(s):
@@ -61,6 +66,9 @@ def facts_to_json(facts_lines, co2Costs=50.0, capitalCosts=0.1):
             p,l,q=sym(t[0]),sym(t[1]),as_num(t[2]); locations.add(l); prods.add(p); offer[p][l]+=q
         elif pred=='demand' and len(t)==3:
             p,l,q=sym(t[0]),sym(t[1]),as_num(t[2]); locations.add(l); prods.add(p); demand[p][l]+=q
+        elif pred=='demandOffer' and len(t)==3:
+            # signed net amount, > 0 offered and < 0 demanded, as in asp_reader.cpp
+            p,l,q=sym(t[0]),sym(t[1]),as_num(t[2]); locations.add(l); prods.add(p); offer[p][l]+=q
         elif pred=='route' and len(t)==5:
             frm,to,tr,dist,_c = sym(t[0]),sym(t[1]),sym(t[2]),as_num(t[3]),as_num(t[4])
             locations.add(frm); locations.add(to); trs.add(tr)
@@ -106,19 +114,59 @@ def facts_to_json(facts_lines, co2Costs=50.0, capitalCosts=0.1):
         ridx+=1
     return J
 
-DUAL_FLOW = re.compile(r'^phi\(([^,]+),([^)\s]+)\)=([+-]?\d+(?:\.\d+)?)$')
-DUAL_COV  = re.compile(r'^dualCover\(([^,>]+)->([^,]+),([^)\s]+)\)=([+-]?\d+(?:\.\d+)?)$')
+NUM = r'([+-]?(?:\d+(?:\.\d*)?|\.\d+)(?:[eE][+-]?\d+)?|[+-]?inf|nan)'
+DUAL_FLOW = re.compile(r'^phi\(([^,]+),([^)\s]+)\)=' + NUM + '$')
+DUAL_COV  = re.compile(r'^dualCover\(([^,>]+)->([^,]+),([^)\s]+)\)=' + NUM + '$')
+
+# binary dual block written by --duals-binary / --duals-file, see dual_io.h
+DUAL_HEADER = struct.Struct('=4sIQQQQd')
+
+def parse_dual_block(buf, offset=0):
+    """returns (objective, L, P, R, flow, cover, end) where flow[l*P+p] and
+    cover[r*P+p] are float64 memoryviews into buf (no copy)"""
+    magic, version, count, L, P, R, obj = DUAL_HEADER.unpack_from(buf, offset)
+    if magic != b'LNOD' or version != 1: raise ValueError("not a dual block")
+    start = offset + DUAL_HEADER.size
+    vals = memoryview(buf)[start:start + 8*count].cast('d')
+    return obj, L, P, R, vals[:L*P], vals[L*P:], start + 8*count
+
+def read_duals_binary(stream):
+    """reads one dual block from a binary stream (e.g. the solver's stdout pipe)"""
+    head = stream.read(DUAL_HEADER.size)
+    count = DUAL_HEADER.unpack(head)[2]
+    return parse_dual_block(head + stream.read(8*count))[:6]
 
-def run_rmp(stdin_json: dict, exe="./lno_rmp_stdin", scale=1000):
+def read_duals_mmap(path):
+    """maps the dual file written by --duals-file; views stay valid while the map is open"""
+    with open(path, 'rb') as f:
+        m = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+    return parse_dual_block(m)[:6]
+
+def duals_by_name(J, block):
+    """keys the dense dual arrays with the location/product names and route endpoints of J
+    (dense ids follow the sorted json keys, as nlohmann::json iterates them)"""
+    obj, L, P, R, flow, cover = block
+    locs  = [J["locations"][k]["name"] for k in sorted(J["locations"])]
+    prods = [J["products"][k]["name"]  for k in sorted(J["products"])]
+    routes= [(J["locations"][J["routes"][k]["from"]]["name"], J["locations"][J["routes"][k]["to"]]["name"])
+             for k in sorted(J["routes"])]
+    phi = [("phi", locs[l], prods[p], flow[l*P+p]) for l in range(L) for p in range(P)]
+    pi  = [("dualCover", routes[r][0], routes[r][1], prods[p], cover[r*P+p]) for r in range(R) for p in range(P)]
+    return obj, phi, pi
+
+def run_rmp_binary(stdin_json: dict, exe="./lno_rmp_stdin"):
+    """like run_rmp, but exchanges the duals as one binary block; returns (objective, phi, dualCover)"""
     p = subprocess.run(
-        [exe],
+        [exe, "--duals-binary"],
         input=json.dumps(stdin_json).encode(),
         stdout=subprocess.PIPE, stderr=subprocess.PIPE, check=True
     )
-    out = p.stdout.decode().splitlines()
+    return duals_by_name(stdin_json, parse_dual_block(p.stdout)[:6])
+
+def duals_to_asp(lines, scale=1000):
     phi=[]; pi=[]
     in_flow=in_cov=False
-    for line in out:
+    for line in lines:
         line=line.strip()
         if line=="DUALS_FLOW_BEGIN": in_flow=True; continue
         if line=="DUALS_FLOW_END":   in_flow=False; continue
@@ -130,7 +178,10 @@ def run_rmp(stdin_json: dict, exe="./lno_rmp_stdin", scale=1000):
         elif in_cov:
             m=DUAL_COV.match(line)
             if m: pi.append(("dualCover", m.group(1), m.group(2), m.group(3), float(m.group(4))))
-    # emit ASP facts
+    return asp_duals(phi, pi, scale)
+
+def asp_duals(phi, pi, scale=1000):
+    """phi/3 and dualCover/3 facts from named duals as returned by duals_by_name"""
     asp = []
     for _,l,p,v in phi:
         asp.append(f"phi({l},{p},{int(round(v*scale))}).")
@@ -139,12 +190,139 @@ def run_rmp(stdin_json: dict, exe="./lno_rmp_stdin", scale=1000):
         asp.append(f"dualCover({frm}->{to},{p},{int(round(v*scale))}).")
     return "\n".join(asp) + "\n"
 
+def core_duals(inst, session):
+    """(objective, phi, dualCover) of an lno_core session, named like duals_by_name; the
+    values are read from views of the solver's dual vector"""
+    locs, prods, ends = inst.location_names, inst.product_names, inst.route_ends
+    flow, cover = session.flow_duals, session.cover_duals
+    phi = [("phi", locs[l], prods[p], float(flow[l, p])) for l in range(inst.L) for p in range(inst.P)]
+    pi  = [("dualCover", ends[r][0], ends[r][1], prods[p], float(cover[r, p])) for r in range(inst.R) for p in range(inst.P)]
+    return session.objective, phi, pi
+
+def run_rmp(stdin_json: dict, exe=None, scale=1000):
+    """dual facts of the RMP; in-process with lno_core unless an executable is given"""
+    if exe is None and lno_core is not None:
+        inst = lno_core.Instance.from_json(json.dumps(stdin_json))
+        session = lno_core.Session(inst)
+        if not session.solve(): raise RuntimeError("RMP not optimal")
+        _, phi, pi = core_duals(inst, session)
+        return asp_duals(phi, pi, scale)
+    p = subprocess.run(
+        [exe or "./lno_rmp_stdin"],
+        input=json.dumps(stdin_json).encode(),
+        stdout=subprocess.PIPE, stderr=subprocess.PIPE, check=True
+    )
+    return duals_to_asp(p.stdout.decode().splitlines(), scale)
+
+def run_rmp_batch(instances, exe="./lno_rmp_stdin", workers=0, scale=1000):
+    """solves many instances in one `--batch` process; returns the dual facts per
+    instance in input order, None for instances that failed"""
+    p = subprocess.run(
+        [exe, "--batch", "--workers", str(workers)],
+        input="".join(json.dumps(J) + "\n" for J in instances).encode(),
+        stdout=subprocess.PIPE, stderr=subprocess.PIPE
+    )
+    # exit code 1 only means that some job failed, those are reported as None
+    if p.returncode not in (0, 1):
+        raise subprocess.CalledProcessError(p.returncode, p.args, p.stdout, p.stderr)
+    results, body, ok = [], [], False
+    for line in p.stdout.decode().splitlines():
+        if line.startswith("RESULT "):
+            body, ok = [], line.rstrip().endswith(" OK")
+        elif line.startswith("END "):
+            results.append(duals_to_asp(body, scale) if ok else None)
+        else:
+            body.append(line)
+    return results
+
+class RmpSession:
+    """Long-lived `lno_rmp_stdin --session` process: the RMP is built once and
+    every solve() re-optimizes from the previous basis."""
+    def __init__(self, stdin_json: dict, exe="./lno_rmp_stdin"):
+        self.p = subprocess.Popen([exe, "--session"], stdin=subprocess.PIPE,
+                                  stdout=subprocess.PIPE, text=True, bufsize=1)
+        self._send(json.dumps(stdin_json))
+
+    def _send(self, line):
+        self.p.stdin.write(line + "\n"); self.p.stdin.flush()
+
+    def add_column(self, route_id, tr_id, counts):
+        """counts: {product_id: units}; returns the column id"""
+        self._send(f"column {route_id} {tr_id} " + " ".join(f"{p}={n}" for p,n in counts.items()))
+        return int(self.p.stdout.readline().split()[1])
+
+    def remove_columns(self, ids):
+        self._send("remove " + " ".join(str(i) for i in ids))
+
+    def solve(self):
+        """returns (objective, phi, dualCover) or None if the RMP is infeasible"""
+        self._send("solve")
+        head = self.p.stdout.readline().split()
+        if head[0] == "INFEASIBLE": return None
+        obj = float(head[1]); phi=[]; pi=[]
+        while True:
+            line = self.p.stdout.readline().strip()
+            if line == "DUALS_COVER_END": break
+            m = DUAL_FLOW.match(line)
+            if m: phi.append(("phi", m.group(1), m.group(2), float(m.group(3)))); continue
+            m = DUAL_COV.match(line)
+            if m: pi.append(("dualCover", m.group(1), m.group(2), m.group(3), float(m.group(4))))
+        return obj, phi, pi
+
+    def close(self):
+        self._send("quit"); self.p.wait()
+
+class CoreRmpSession:
+    """RmpSession without the process: the same calls on an lno_core session in this
+    interpreter, built from the json instance or directly from a fact file."""
+    def __init__(self, stdin_json: dict = None, facts=None, presolve=False):
+        if facts is not None:
+            self.inst = lno_core.Instance.from_facts(facts, presolve=presolve)
+        else:
+            self.inst = lno_core.Instance.from_json(json.dumps(stdin_json), presolve=presolve)
+        self.session = lno_core.Session(self.inst)
+        self.route_id = {k: i for i, k in enumerate(self.inst.route_keys)}
+        self.tr_id = {k: i for i, k in enumerate(self.inst.transport_resource_keys)}
+        self.product_id = {k: i for i, k in enumerate(self.inst.product_keys)}
+
+    def add_column(self, route_id, tr_id, counts):
+        """counts: {product_id: units}, ids are the instance keys; returns the column id"""
+        return self.session.add_column(self.route_id[route_id], self.tr_id[tr_id],
+                                       {self.product_id[p]: n for p, n in counts.items()})
+
+    def remove_columns(self, ids):
+        self.session.remove_columns(list(ids))
+
+    def solve(self):
+        """returns (objective, phi, dualCover) or None if the RMP is infeasible"""
+        if not self.session.solve(): return None
+        return core_duals(self.inst, self.session)
+
+    def duals(self):
+        """(flow[l, p], cover[r, p]) as read-only NumPy views, updated in place by every solve"""
+        return self.session.flow_duals, self.session.cover_duals
+
+    def close(self):
+        pass
+
 if __name__=="__main__":
     facts_path = sys.argv[1]
-    exe        = sys.argv[2] if len(sys.argv)>2 else "./lno_rmp_stdin"
-    with open(facts_path,'r') as f:
-        J = facts_to_json(f.readlines())
-    asp_duals = run_rmp(J, exe=exe, scale=1000)
+    exe        = sys.argv[2] if len(sys.argv)>2 else None
+    # an explicit executable wins over the in-process core
+    if exe is None and lno_core is not None:
+        print("RMP backend: lno_core (in-process)", file=sys.stderr)
+        # in-process: the facts are read by the C++ loader, no json in between; facts_to_json
+        # reads the same predicates (tests/test_controller_facts.py), so both backends agree
+        core = CoreRmpSession(facts=facts_path)
+        if core.solve() is None: sys.exit("RMP not optimal")
+        _, phi, pi = core_duals(core.inst, core.session)
+        facts = asp_duals(phi, pi, scale=1000)
+    else:
+        exe = exe or "./lno_rmp_stdin"
+        print("RMP backend: " + exe, file=sys.stderr)
+        with open(facts_path,'r') as f:
+            J = facts_to_json(f.readlines())
+        facts = run_rmp(J, exe=exe, scale=1000)
     # write the duals for the pricing ASP
-    with open("duals_out.lp","w") as g: g.write(asp_duals)
+    with open("duals_out.lp","w") as g: g.write(facts)
     print("Wrote duals_out.lp")
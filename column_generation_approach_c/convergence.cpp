@@ -0,0 +1,72 @@
+//
+// Lower bounds and early termination of column generation.
+//
+
+#include "convergence.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+double farley_bound(const Instance &instance, const vector<double> &best, double rmpObjective) {
+  const Settings &settings = instance.settings;
+  double theta = 1.0;
+  for (size_t r = 0; r < instance.R && r < best.size(); ++r) {
+    if (best[r] >= 0)
+      continue;
+
+    // the capital costs of the load are nonnegative, so the bare trip is the cheapest packing
+    double cheapest = numeric_limits<double>::infinity();
+    for (size_t k = instance.routeTRStart[r]; k < instance.routeTRStart[r + 1]; ++k) {
+      const int tr = instance.routeTR[k];
+      if (!instance.enabled(r, tr))
+        continue;
+      cheapest = min(cheapest, instance.routeDistance[k] *
+                                   (instance.trCost[tr] + settings.co2Costs * instance.trCo2Emissions[tr]));
+    }
+    if (cheapest == numeric_limits<double>::infinity())
+      continue;
+    theta = min(theta, cheapest / (cheapest - best[r]));
+  }
+  return theta * rmpObjective;
+}
+
+vector<double> best_per_route(const Instance &instance, const vector<Packing> &columns,
+                              const vector<double> &redcosts) {
+  vector<double> best(instance.R, 0.0);
+  for (size_t i = 0; i < columns.size(); ++i)
+    best[columns[i].route] = min(best[columns[i].route], redcosts[i]);
+  return best;
+}
+
+ConvergenceMonitor::ConvergenceMonitor(const ConvergenceOptions &options) : _options(options) { reset(); }
+
+void ConvergenceMonitor::record(double objective, double lowerBound) {
+  _objectives.push_back(objective);
+  if (_objectives.size() > _options.tailingRounds + 1)
+    _objectives.pop_front();
+  _lowerBound = max(_lowerBound, lowerBound);
+}
+
+void ConvergenceMonitor::reset() {
+  _objectives.clear();
+  _lowerBound = -numeric_limits<double>::infinity();
+}
+
+double ConvergenceMonitor::gap() const {
+  if (_objectives.empty() || _lowerBound == -numeric_limits<double>::infinity())
+    return numeric_limits<double>::infinity();
+  const double objective = _objectives.back();
+  return max(0.0, objective - _lowerBound) / max(1.0, fabs(objective));
+}
+
+bool ConvergenceMonitor::gap_closed() const { return _options.gap > 0 && gap() <= _options.gap; }
+
+bool ConvergenceMonitor::tailing_off() const {
+  if (_options.tailingRounds == 0 || _objectives.size() <= _options.tailingRounds)
+    return false;
+  const double first = _objectives.front(), last = _objectives.back();
+  return first - last <= _options.tailingImprovement * max(1.0, fabs(first));
+}
@@ -0,0 +1,67 @@
+//
+// Lower bounds and early termination of column generation.
+//
+
+#ifndef LNO_CONVERGENCE_H
+#define LNO_CONVERGENCE_H
+
+#include <deque>
+#include <vector>
+
+#include "instance.h"
+#include "packing.h"
+
+using namespace std;
+
+/** when column generation may stop before pricing finds no improving column */
+struct ConvergenceOptions {
+  double gap = 0.0;                 // stop once (RMP value - lower bound) / max(1, |RMP value|) <= gap, 0 = off
+  size_t tailingRounds = 0;         // stop if the RMP value improved by less than tailingImprovement
+  double tailingImprovement = 1e-3; // (relative) over the last tailingRounds rounds, 0 rounds = off
+};
+
+/** Farley's lower bound on the master LP from a complete pricing round
+ *
+ *  best[r] is the most negative reduced cost of a packing on route r at the duals of the RMP
+ *  whose value is rmpObjective (0 if none is negative). Every packing on r costs at least the
+ *  cheapest trip c_r of an enabled transport resource, so scaling the duals by
+ *  theta = min(1, min_r c_r / (c_r - best[r])) makes them feasible for every column, and all
+ *  costs being nonnegative, theta * rmpObjective is a lower bound. Unlike the Lagrangian bound it
+ *  needs no bound on the number of trips.
+ */
+double farley_bound(const Instance &instance, const vector<double> &best, double rmpObjective);
+
+/** most negative reduced cost per route of the packings found by price_routes */
+vector<double> best_per_route(const Instance &instance, const vector<Packing> &columns,
+                              const vector<double> &redcosts);
+
+/** tracks the RMP value and the best lower bound round by round */
+class ConvergenceMonitor {
+public:
+  explicit ConvergenceMonitor(const ConvergenceOptions &options = ConvergenceOptions());
+
+  /** records a round, the bound is only kept if it improves the best one */
+  void record(double objective, double lowerBound);
+
+  /** forgets everything, e.g. when SCIP moves to another node */
+  void reset();
+
+  double lower_bound() const { return _lowerBound; }
+
+  /** relative gap of the last round, infinite without a bound */
+  double gap() const;
+
+  bool gap_closed() const;
+
+  /** the RMP value changed by less than tailingImprovement over the last tailingRounds rounds */
+  bool tailing_off() const;
+
+  bool stop() const { return gap_closed() || tailing_off(); }
+
+private:
+  ConvergenceOptions _options;
+  deque<double> _objectives; // the last tailingRounds + 1 RMP values
+  double _lowerBound;
+};
+
+#endif // LNO_CONVERGENCE_H
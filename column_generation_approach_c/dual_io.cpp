@@ -0,0 +1,56 @@
+#include "dual_io.h"
+#include <atomic>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+using namespace scip;
+
+static DualBlockHeader make_header(const RmpSession& session)
+{
+  const Instance& inst = session.instance();
+  DualBlockHeader h;
+  std::memcpy(h.magic, "LNOD", 4);
+  h.version   = DUAL_BLOCK_VERSION;
+  h.count     = session.duals().size();
+  h.L = inst.L; h.P = inst.P; h.R = inst.R;
+  h.objective = session.objective();
+  return h;
+}
+
+SCIP_RETCODE write_duals_binary(std::ostream& os, const RmpSession& session)
+{
+  const DualBlockHeader h = make_header(session);
+  os.write(reinterpret_cast<const char*>(&h), sizeof h);
+  os.write(reinterpret_cast<const char*>(session.duals().data()), (std::streamsize)(h.count*sizeof(double)));
+  os.flush();
+  return os ? SCIP_OKAY : SCIP_WRITEERROR;
+}
+
+SCIP_RETCODE write_duals_mmap(const char* path, const RmpSession& session)
+{
+  const DualBlockHeader h = make_header(session);
+  const size_t bytes = sizeof h + h.count*sizeof(double);
+
+  int fd = open(path, O_RDWR | O_CREAT, 0644);
+  if (fd<0) return SCIP_FILECREATEERROR;
+  if (ftruncate(fd, (off_t)bytes)!=0) { close(fd); return SCIP_WRITEERROR; }
+
+  void* map = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (map==MAP_FAILED) return SCIP_WRITEERROR;
+
+  // The file is rewritten in place on every solve, so the previous block's magic is cleared
+  // before the values are copied and set again after the rest of the header. This only lets a
+  // reader that looks early tell a block in progress from a finished one; readers synchronize
+  // on the stdout line that follows the write (see dual_io.h).
+  char* dst = static_cast<char*>(map);
+  std::memset(dst, 0, sizeof h.magic);
+  std::atomic_thread_fence(std::memory_order_release);
+  std::memcpy(dst + sizeof h, session.duals().data(), h.count*sizeof(double));
+  std::memcpy(dst + sizeof h.magic, reinterpret_cast<const char*>(&h) + sizeof h.magic, sizeof h - sizeof h.magic);
+  std::atomic_thread_fence(std::memory_order_release);
+  std::memcpy(dst, h.magic, sizeof h.magic);
+  munmap(map, bytes);
+  return SCIP_OKAY;
+}
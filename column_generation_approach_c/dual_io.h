@@ -0,0 +1,29 @@
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include "rmp_core.h"
+
+// Binary dual exchange. A block is a fixed 48-byte header followed by `count`
+// native-endian float64 values: first the flow duals at location*P + product,
+// then the cover duals at route*P + product (ids are the dense instance ids,
+// i.e. the json keys of each section in sorted order).
+struct DualBlockHeader {
+  char     magic[4];   // "LNOD"
+  uint32_t version;    // DUAL_BLOCK_VERSION
+  uint64_t count;      // number of float64 values following the header (L*P + R*P)
+  uint64_t L, P, R;
+  double   objective;
+};
+static_assert(sizeof(DualBlockHeader)==48, "dual block header must stay 48 bytes");
+
+constexpr uint32_t DUAL_BLOCK_VERSION = 1;
+
+// writes one block to a stream, e.g. the stdout pipe the controller reads from
+scip::SCIP_RETCODE write_duals_binary(std::ostream& os, const RmpSession& session);
+
+// writes one block into a memory-mapped file (created or resized as needed). The file is
+// overwritten by every solve of a session, so a reader may only take the block as complete once
+// the writer said so: in session mode the "OBJ ..." / "CG OBJ ..." line is printed after the
+// write, otherwise the process has to exit first. The magic is zero while a block is being
+// written, which catches a reader that does not wait.
+scip::SCIP_RETCODE write_duals_mmap(const char* path, const RmpSession& session);
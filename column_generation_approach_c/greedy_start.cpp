@@ -0,0 +1,163 @@
+#include "greedy_start.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <map>
+#include <queue>
+#include <utility>
+
+namespace {
+
+const double INF = std::numeric_limits<double>::infinity();
+const double SIZE_EPS = 1e-9;  // same rounding as price_packing
+
+int unit_size(const Instance& inst, size_t p) { return (int)std::ceil(inst.productSize[p] - SIZE_EPS); }
+int capacity(const Instance& inst, int tr)    { return (int)std::floor(inst.trCapacity[tr] + SIZE_EPS); }
+
+// cost per unit of p in a full trip of slot k, infinite if p cannot ride on it
+double unit_cost(const Instance& inst, size_t k, size_t p)
+{
+  const int tr = inst.routeTR[k];
+  const int size = unit_size(inst, p);
+  if (!inst.valid(p, tr) || size <= 0 || capacity(inst, tr) < size) return INF;
+  const int units = capacity(inst, tr) / size;
+  const std::vector<std::tuple<int,int>> items{{(int)p, units}};
+  return packing_cost(inst, tr, inst.routeDistance[k], items) / units;
+}
+
+// one or more identical trips of a slot
+struct Bin {
+  size_t slot;
+  int free;                 // capacity left in each trip
+  std::map<int,int> items;  // product -> units per trip
+  int freq;
+};
+
+// first-fit-decreasing of the flow on route r into trips, bestSlot[p] opens new trips for p
+void pack_route(const Instance& inst, size_t r, const std::vector<int>& flow, const std::vector<int>& bestSlot,
+                std::vector<Bin>& bins)
+{
+  std::vector<size_t> order;
+  for (size_t p=0; p<inst.P; ++p) if (flow[p] > 0) order.push_back(p);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return unit_size(inst, a) > unit_size(inst, b); });
+
+  bins.clear();
+  for (size_t p: order) {
+    const int size = unit_size(inst, p);
+    int n = flow[p];
+    for (auto& bin: bins) {
+      if (n < bin.freq || bin.free < size || !inst.valid(p, inst.routeTR[bin.slot])) continue;
+      const int k = std::min(bin.free/size, n/bin.freq);
+      bin.items[(int)p] += k; bin.free -= k*size; n -= k*bin.freq;
+      if (n == 0) break;
+    }
+    if (n == 0) continue;
+
+    // full trips as one group, the rest in one more trip the next products can fill up
+    const size_t slot = (size_t)bestSlot[inst.rp(r,p)];
+    const int cap = capacity(inst, inst.routeTR[slot]);
+    const int full = cap/size;
+    if (n >= full) bins.push_back(Bin{slot, cap - full*size, {{(int)p, full}}, n/full});
+    if (n % full) bins.push_back(Bin{slot, cap - (n % full)*size, {{(int)p, n % full}}, 1});
+  }
+}
+
+} // namespace
+
+bool greedy_plan(const Instance& inst, TransportPlan& plan)
+{
+  const size_t L = inst.L, P = inst.P, R = inst.R;
+  plan = TransportPlan();
+
+  // arc weights and the slot used for new trips, per (r,p)
+  std::vector<double> weight(R*P, INF);
+  std::vector<int> bestSlot(R*P, -1);
+  for (size_t r=0; r<R; ++r) for (size_t p=0; p<P; ++p) {
+    if (!inst.active(r,p)) continue;
+    for (size_t k=inst.routeTRStart[r]; k<inst.routeTRStart[r+1]; ++k) {
+      if (!inst.enabled(r, inst.routeTR[k])) continue;
+      const double c = unit_cost(inst, k, p);
+      if (c < weight[inst.rp(r,p)]) { weight[inst.rp(r,p)] = c; bestSlot[inst.rp(r,p)] = (int)k; }
+    }
+  }
+
+  // per product: Dijkstra backwards from each demand, take the nearest supplies first
+  std::vector<int> flow(R*P, 0);
+  std::vector<double> dist(L);
+  std::vector<int> next(L);  // route leaving the location towards the demand
+  std::vector<int> supply(L);
+  bool complete = true;
+  using Entry = std::pair<double,size_t>;
+  for (size_t p=0; p<P; ++p) {
+    for (size_t l=0; l<L; ++l) supply[l] = std::max(0, inst.netSupplyDemand[inst.lp(l,p)]);
+
+    for (size_t d=0; d<L; ++d) {
+      int demand = -std::min(0, inst.netSupplyDemand[inst.lp(d,p)]);
+      if (demand == 0) continue;
+
+      std::fill(dist.begin(), dist.end(), INF);
+      std::fill(next.begin(), next.end(), -1);
+      std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+      std::vector<size_t> reached;
+      dist[d] = 0.0; heap.push({0.0, d});
+      while (!heap.empty()) {
+        auto [du, u] = heap.top(); heap.pop();
+        if (du > dist[u]) continue;
+        reached.push_back(u);
+        for (size_t k=inst.incidence.inStart[u]; k<inst.incidence.inStart[u+1]; ++k) {
+          const size_t r = inst.incidence.inRoutes[k];
+          const size_t v = (size_t)inst.routeFrom[r];
+          const double dv = du + weight[inst.rp(r,p)];
+          if (dv < dist[v]) { dist[v] = dv; next[v] = (int)r; heap.push({dv, v}); }
+        }
+      }
+
+      // reached is ordered by distance
+      for (size_t s: reached) {
+        if (demand == 0) break;
+        const int q = std::min(supply[s], demand);
+        if (q <= 0) continue;
+        supply[s] -= q; demand -= q;
+        for (size_t v=s; v!=d; v=(size_t)inst.routeTo[next[v]]) flow[inst.rp((size_t)next[v],p)] += q;
+      }
+      if (demand > 0) complete = false;
+    }
+  }
+
+  std::vector<int> routeFlow(P);
+  std::vector<Bin> bins;
+  for (size_t r=0; r<R; ++r) {
+    bool any = false;
+    for (size_t p=0; p<P; ++p) {
+      routeFlow[p] = flow[inst.rp(r,p)];
+      if (routeFlow[p] > 0) { plan.flows.emplace_back((int)r, (int)p, routeFlow[p]); any = true; }
+    }
+    if (!any) continue;
+
+    pack_route(inst, r, routeFlow, bestSlot, bins);
+    std::map<std::pair<size_t, std::map<int,int>>, int> merged;
+    for (const auto& bin: bins) merged[{bin.slot, bin.items}] += bin.freq;
+    for (const auto& [key, freq]: merged) {
+      Packing packing;
+      packing.route = (int)r;
+      packing.transportResource = inst.routeTR[key.first];
+      packing.distance = inst.routeDistance[key.first];
+      for (const auto& [p, units]: key.second) packing.items.emplace_back(p, units);
+      packing.cost = packing_cost(inst, packing.transportResource, packing.distance, packing.items);
+      plan.cost += freq*packing.cost;
+      plan.links.emplace_back(std::move(packing), freq);
+    }
+  }
+  return complete;
+}
+
+SCIP_RETCODE seed_columns(RmpSession& session, const TransportPlan& plan, std::vector<int>* ids)
+{
+  for (const auto& link: plan.links) {
+    int id = -1;
+    SCIP_CALL( session.add_column(link.first, &id) );
+    if (ids) ids->push_back(id);
+  }
+  return SCIP_OKAY;
+}
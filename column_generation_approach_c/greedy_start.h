@@ -0,0 +1,18 @@
+#pragma once
+#include <vector>
+#include "primal_heuristic.h"
+
+// Constructive start: per product, every demand is served from the nearest supplies along
+// shortest paths of the route graph, with a route weighing what one unit costs in a full
+// trip of its cheapest transport resource for the product. The flow of each route is then
+// packed first-fit-decreasing (largest products first) into trips of those resources.
+// Pairs pruned by presolve and disabled routes or transport resources (replan.h) are not used.
+//
+// plan holds the flows and the distinct packings with their frequencies; returns true if every
+// demand was routed, i.e. the plan is a feasible integer solution and plan.cost a primal bound.
+// Otherwise the packings found are still good initial columns.
+bool greedy_plan(const Instance& instance, TransportPlan& plan);
+
+// appends the plan's packings to the RMP before its first solve, so the first LP no longer
+// needs the Big-M y columns for the routed flow; ids receives the new column ids if given
+scip::SCIP_RETCODE seed_columns(RmpSession& session, const TransportPlan& plan, std::vector<int>* ids = nullptr);
@@ -0,0 +1,89 @@
+//
+// Dense, integer-indexed view of an LNO instance.
+//
+
+#include "instance.h"
+
+#include <cctype>
+#include <cstdio>
+
+using namespace std;
+
+Instance build_instance(const Settings &settings, const vector<Location *> &locations,
+                        const vector<TransportResource *> &transportResources,
+                        const vector<Product *> &products, const vector<Route *> &routes) {
+  Instance instance;
+  instance.settings = settings;
+  instance.locations = locations;
+  instance.transportResources = transportResources;
+  instance.products = products;
+  instance.routes = routes;
+
+  instance.L = locations.size();
+  instance.T = transportResources.size();
+  instance.P = products.size();
+  instance.R = routes.size();
+
+  for (size_t l = 0; l < instance.L; ++l)
+    locations[l]->id = (int)l;
+
+  for (size_t t = 0; t < instance.T; ++t) {
+    const TransportResource *tr = transportResources[t];
+    transportResources[t]->id = (int)t;
+    instance.trCapacity.push_back(tr->capacity);
+    instance.trCo2Emissions.push_back(tr->co2Emissions);
+    instance.trCost.push_back(tr->cost);
+    instance.trSpeed.push_back(tr->speed);
+  }
+
+  instance.validTR.assign(instance.P * instance.T, 0);
+  instance.netSupplyDemand.assign(instance.L * instance.P, 0);
+  for (size_t p = 0; p < instance.P; ++p) {
+    Product *product = products[p];
+    product->id = (int)p;
+    instance.productSize.push_back(product->size);
+    instance.productValue.push_back(product->value);
+
+    for (const auto &tr : product->validTR)
+      instance.validTR[p * instance.T + tr->id] = 1;
+
+    // locations without an entry are neither supply nor demand
+    for (const auto &entry : product->netSupplyDemand)
+      instance.netSupplyDemand[instance.lp(entry.first->id, p)] = entry.second;
+  }
+
+  instance.routeTRStart.push_back(0);
+  for (size_t r = 0; r < instance.R; ++r) {
+    Route *route = routes[r];
+    route->id = (int)r;
+    instance.routeFrom.push_back(route->from->id);
+    instance.routeTo.push_back(route->to->id);
+
+    for (const auto &entry : route->transportResources) {
+      instance.routeTR.push_back(get<0>(entry)->id);
+      instance.routeDistance.push_back(get<1>(entry));
+    }
+    instance.routeTRStart.push_back(instance.routeTR.size());
+  }
+
+  instance.incidence = LocationIncidence(instance.L, instance.routeFrom, instance.routeTo);
+  instance.pairActive.assign(instance.R * instance.P, 1);
+  instance.flowActive.assign(instance.L * instance.P, 1);
+  instance.routeEnabled.assign(instance.R, 1);
+  instance.trEnabled.assign(instance.T, 1);
+
+  return instance;
+}
+
+string escape_name(string_view name) {
+  string out;
+  for (const char c : name) {
+    if (isspace((unsigned char)c) || c == '%' || c == '=' || !isprint((unsigned char)c)) {
+      char hex[4];
+      snprintf(hex, sizeof hex, "%%%02X", (unsigned char)c);
+      out += hex;
+    } else
+      out += c;
+  }
+  return out;
+}
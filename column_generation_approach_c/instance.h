@@ -0,0 +1,86 @@
+//
+// Dense, integer-indexed view of an LNO instance.
+//
+
+#ifndef LNO_INSTANCE_H
+#define LNO_INSTANCE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "main.h"
+
+using namespace std;
+
+/** flat representation of an instance used by the model builders and the pricer
+ *
+ *  Locations, transport resources, products and routes are identified by their
+ *  position in the corresponding vector, which is also stored in their id field.
+ *  Per (route, product) data is laid out as route * P + product. Presolve never renumbers
+ *  anything, pruned (route, product) pairs and flow rows are only switched off.
+ */
+struct Instance {
+  Settings settings;
+
+  /* domain objects, only needed for names and output */
+  vector<Location *> locations;
+  vector<TransportResource *> transportResources;
+  vector<Product *> products;
+  vector<Route *> routes;
+
+  size_t L = 0; // number of locations
+  size_t T = 0; // number of transport resources
+  size_t P = 0; // number of products
+  size_t R = 0; // number of routes
+
+  /* transport resources */
+  vector<double> trCapacity;
+  vector<double> trCo2Emissions;
+  vector<double> trCost;
+  vector<double> trSpeed;
+
+  /* products */
+  vector<double> productSize;
+  vector<double> productValue;
+  vector<char> validTR;       // [product * T + tr]
+  vector<int> netSupplyDemand; // [location * P + product]
+
+  /* routes, the transport resources of route r are routeTR[routeTRStart[r] .. routeTRStart[r+1]) */
+  vector<int> routeFrom;
+  vector<int> routeTo;
+  vector<size_t> routeTRStart;
+  vector<int> routeTR;
+  vector<double> routeDistance; // parallel to routeTR
+
+  LocationIncidence incidence;
+
+  /* model entries kept by presolve (presolve.h), all set by build_instance */
+  vector<char> pairActive; // [route * P + product], f, y and cover row exist
+  vector<char> flowActive; // [location * P + product], flow conservation row exists
+  bool presolved = false;   // set by presolve_instance, the pairs then depend on the supply and demand
+
+  /* switched by the replanning API (replan.h), all set by build_instance */
+  vector<char> routeEnabled; // [route]
+  vector<char> trEnabled;    // [tr]
+
+  size_t rp(size_t route, size_t product) const { return route * P + product; }
+  size_t lp(size_t location, size_t product) const { return location * P + product; }
+  bool valid(size_t product, size_t tr) const { return validTR[product * T + tr] != 0; }
+  bool active(size_t route, size_t product) const { return pairActive[rp(route, product)] != 0; }
+  bool flow_active(size_t location, size_t product) const { return flowActive[lp(location, product)] != 0; }
+  /** true if packings of the transport resource may be used on the route */
+  bool enabled(size_t route, size_t tr) const { return routeEnabled[route] && trEnabled[tr]; }
+};
+
+/** assigns dense ids to the domain objects and flattens them into an instance */
+Instance build_instance(const Settings &settings, const vector<Location *> &locations,
+                        const vector<TransportResource *> &transportResources,
+                        const vector<Product *> &products, const vector<Route *> &routes);
+
+/** a name as one token of the line based files (snapshot, column pool): whitespace, '%', '=' and
+ *  unprintable characters become %XX. Names are matched in this form, so files stay readable
+ *  wherever the names need no escaping */
+string escape_name(string_view name);
+
+#endif // LNO_INSTANCE_H
@@ -0,0 +1,218 @@
+//
+// Seeded generator of synthetic LNO instances for scaling experiments.
+//
+
+#include "instance_generator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <unordered_map>
+
+using namespace std;
+
+namespace {
+
+/** draws from mt19937_64 only: the distributions of <random> differ between standard libraries */
+class Rng {
+public:
+  explicit Rng(uint64_t seed) : _engine(seed) {}
+
+  /** uniform in [0, n) */
+  size_t below(size_t n) { return (size_t)(_engine() % n); }
+
+  /** uniform in [lo, hi] */
+  int between(int lo, int hi) { return lo + (int)below((size_t)(hi - lo + 1)); }
+
+  /** uniform in [0, 1) */
+  double uniform() { return (double)(_engine() >> 11) * 0x1.0p-53; }
+
+private:
+  mt19937_64 _engine;
+};
+
+/** random nonempty subset of 0..n-1, every element with probability share */
+vector<int> subset(Rng &rng, size_t n, double share) {
+  vector<int> out;
+  for (size_t i = 0; i < n; ++i)
+    if (rng.uniform() < share)
+      out.push_back((int)i);
+  if (out.empty())
+    out.push_back((int)rng.below(n));
+  return out;
+}
+
+/** k distinct random elements of 0..n-1 (partial Fisher-Yates) */
+vector<int> sample(Rng &rng, size_t n, size_t k, vector<int> &scratch) {
+  scratch.resize(n);
+  iota(scratch.begin(), scratch.end(), 0);
+  k = min(k, n);
+  for (size_t i = 0; i < k; ++i)
+    swap(scratch[i], scratch[i + rng.below(n - i)]);
+  return vector<int>(scratch.begin(), scratch.begin() + k);
+}
+
+} // namespace
+
+void generate_instance(const GeneratorOptions &options, GeneratedInstance &instance) {
+  Rng rng(options.seed);
+  const size_t L = options.locations, T = max<size_t>(1, options.transportResources);
+  instance = GeneratedInstance();
+  instance.settings = options.settings;
+  instance.locations = L;
+
+  // the same ranges as the transport resources and parts of instance_paper.lp, a bit wider
+  for (size_t t = 0; t < T; ++t)
+    instance.transportResources.push_back({rng.between(10, 30), rng.between(30, 70), rng.between(30, 60),
+                                           rng.between(1, 4)});
+
+  vector<double> x(L), y(L);
+  for (size_t l = 0; l < L; ++l) {
+    x[l] = 100.0 * rng.uniform();
+    y[l] = 100.0 * rng.uniform();
+  }
+  auto distance = [&](size_t a, size_t b) { return max(1, (int)lround(hypot(x[a] - x[b], y[a] - y[b]))); };
+
+  // one route per (from, to), a second draw of the same pair only adds transport resources
+  unordered_map<uint64_t, size_t> routeOf;
+  auto addRoute = [&](size_t from, size_t to, const vector<int> &trs) {
+    if (from == to)
+      return;
+    auto [it, inserted] = routeOf.emplace((uint64_t)from * L + to, instance.routes.size());
+    if (inserted)
+      instance.routes.push_back({(int)from, (int)to, {}});
+    auto &route = instance.routes[it->second];
+    for (int tr : trs)
+      if (none_of(route.transportResources.begin(), route.transportResources.end(),
+                  [&](const pair<int, int> &e) { return e.first == tr; }))
+        route.transportResources.emplace_back(tr, distance(from, to));
+  };
+
+  vector<int> allTRs(T);
+  iota(allTRs.begin(), allTRs.end(), 0);
+  if (L > 1) {
+    for (size_t l = 0; l < L; ++l) {
+      addRoute(l, (l + 1) % L, allTRs);
+      addRoute((l + 1) % L, l, allTRs);
+    }
+    for (size_t l = 0; l < L; ++l) {
+      size_t n = (size_t)options.degree;
+      if (rng.uniform() < options.degree - (double)n)
+        ++n;
+      for (size_t i = 0; i < n; ++i)
+        addRoute(l, rng.below(L), subset(rng, T, 0.6));
+    }
+  }
+
+  vector<int> scratch;
+  for (size_t p = 0; p < options.products; ++p) {
+    GeneratedInstance::Product product;
+    product.size = rng.between(1, 5);
+    product.value = rng.between(200, 2000);
+    product.validTR = subset(rng, T, 0.7);
+
+    if (L > 1) {
+      const size_t terminals = min(L, max<size_t>(2, (size_t)lround(options.terminals * (double)L)));
+      const size_t sources =
+          min(terminals - 1, max<size_t>(1, (size_t)lround((double)terminals * (1.0 - options.imbalance) / 2)));
+      const vector<int> chosen = sample(rng, L, terminals, scratch);
+
+      int total = 0;
+      for (size_t i = sources; i < terminals; ++i) {
+        const int units = rng.between(1, 20);
+        product.netSupplyDemand.emplace_back(chosen[i], -units);
+        total += units;
+      }
+      for (size_t i = 0; i < sources; ++i) {
+        const int units = total / (int)sources + ((int)i < total % (int)sources ? 1 : 0);
+        if (units > 0)
+          product.netSupplyDemand.emplace_back(chosen[i], units);
+      }
+      sort(product.netSupplyDemand.begin(), product.netSupplyDemand.end());
+    }
+    instance.products.push_back(std::move(product));
+  }
+}
+
+void write_instance_json(ostream &os, const GeneratedInstance &instance) {
+  os << "{\"settings\": {\"co2Costs\": " << instance.settings.co2Costs
+     << ", \"capitalCosts\": " << instance.settings.capitalCosts << "}, \"locations\": {";
+  for (size_t l = 0; l < instance.locations; ++l)
+    os << (l ? ", " : "") << "\"L" << l + 1 << "\": {\"name\": \"l" << l + 1 << "\"}";
+
+  os << "}, \"transportResources\": {";
+  for (size_t t = 0; t < instance.transportResources.size(); ++t) {
+    const auto &tr = instance.transportResources[t];
+    os << (t ? ", " : "") << "\"TR" << t + 1 << "\": {\"name\": \"tr" << t + 1 << "\", \"capacity\": " << tr.capacity
+       << ", \"co2Emissions\": " << tr.co2Emissions << ", \"cost\": " << tr.cost << ", \"speed\": " << tr.speed << "}";
+  }
+
+  os << "}, \"products\": {";
+  for (size_t p = 0; p < instance.products.size(); ++p) {
+    const auto &product = instance.products[p];
+    os << (p ? ", " : "") << "\"P" << p + 1 << "\": {\"name\": \"p" << p + 1 << "\", \"validTR\": [";
+    for (size_t i = 0; i < product.validTR.size(); ++i)
+      os << (i ? ", " : "") << "\"TR" << product.validTR[i] + 1 << "\"";
+    os << "], \"size\": " << product.size << ", \"value\": " << product.value << ", \"netSupplyDemand\": {";
+    for (size_t i = 0; i < product.netSupplyDemand.size(); ++i)
+      os << (i ? ", " : "") << "\"L" << product.netSupplyDemand[i].first + 1
+         << "\": " << product.netSupplyDemand[i].second;
+    os << "}}";
+  }
+
+  os << "}, \"routes\": {";
+  for (size_t r = 0; r < instance.routes.size(); ++r) {
+    const auto &route = instance.routes[r];
+    os << (r ? ", " : "") << "\"R" << r + 1 << "\": {\"from\": \"L" << route.from + 1 << "\", \"to\": \"L"
+       << route.to + 1 << "\", \"transportResources\": {";
+    for (size_t i = 0; i < route.transportResources.size(); ++i)
+      os << (i ? ", " : "") << "\"TR" << route.transportResources[i].first + 1
+         << "\": {\"distance\": " << route.transportResources[i].second << "}";
+    os << "}}";
+  }
+  os << "}}\n";
+}
+
+void write_instance_facts(ostream &os, const GeneratedInstance &instance) {
+  // the settings are not part of the fact format, readers use FACT_FORMAT_SETTINGS (main.h)
+  os << "% generated: " << instance.locations << " locations, " << instance.transportResources.size()
+     << " transport resources, " << instance.products.size() << " parts, " << instance.routes.size() << " routes\n";
+
+  os << "\n% location: name\n";
+  for (size_t l = 0; l < instance.locations; ++l)
+    os << "location(l" << l + 1 << ").\n";
+
+  os << "\n% transportResource: name, capacity, co2emissions, cost, speed\n";
+  for (size_t t = 0; t < instance.transportResources.size(); ++t) {
+    const auto &tr = instance.transportResources[t];
+    os << "transportResource(tr" << t + 1 << ").\n";
+    os << "transportCapacity(tr" << t + 1 << "," << tr.capacity << ").\n";
+    os << "transportCO2(tr" << t + 1 << "," << tr.co2Emissions << ").\n";
+    os << "transportCost(tr" << t + 1 << "," << tr.cost << ").\n";
+    os << "transportSpeed(tr" << t + 1 << "," << tr.speed << ").\n";
+  }
+
+  os << "\n% Part: name, validTR, size, value, offer / demand\n";
+  for (size_t p = 0; p < instance.products.size(); ++p) {
+    const auto &product = instance.products[p];
+    os << "part(p" << p + 1 << ").\n";
+    os << "partSize(p" << p + 1 << "," << product.size << ").\n";
+    os << "partVal(p" << p + 1 << "," << product.value << ").\n";
+    for (int tr : product.validTR)
+      os << "partTR(p" << p + 1 << ",tr" << tr + 1 << ").\n";
+    for (const auto &[l, units] : product.netSupplyDemand)
+      os << (units > 0 ? "offer" : "demand") << "(p" << p + 1 << ",l" << l + 1 << "," << abs(units) << ").\n";
+  }
+
+  // the last argument is the trip cost of the instance's settings, rounded; as in presolve the
+  // capital costs of the load are not part of it. The loaders only read the distance
+  const double co2Costs = instance.settings.co2Costs;
+  os << "\n% route: from, to, transportResource, distance, cost\n";
+  for (const auto &route : instance.routes)
+    for (const auto &[tr, distance] : route.transportResources) {
+      const auto &resource = instance.transportResources[tr];
+      os << "route(l" << route.from + 1 << ",l" << route.to + 1 << ",tr" << tr + 1 << "," << distance << ","
+         << lround(distance * (resource.cost + co2Costs * resource.co2Emissions)) << ").\n";
+    }
+}
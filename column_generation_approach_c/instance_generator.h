@@ -0,0 +1,68 @@
+//
+// Seeded generator of synthetic LNO instances for scaling experiments.
+//
+
+#ifndef LNO_INSTANCE_GENERATOR_H
+#define LNO_INSTANCE_GENERATOR_H
+
+#include <cstdint>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include "main.h"
+
+using namespace std;
+
+struct GeneratorOptions {
+  size_t locations = 100;
+  size_t products = 5;
+  size_t transportResources = 3;
+  double degree = 3.0;     // route density: random routes leaving a location on average, on top of the ring
+  double terminals = 0.1;  // share of the locations with supply or demand, per product
+  double imbalance = 0.0;  // 0 = as many sources as sinks, towards 1 a few sources serve many sinks
+  uint64_t seed = 1;
+  Settings settings = FACT_FORMAT_SETTINGS;
+};
+
+/** a generated instance, ids are positions; names are l1.., tr1.., p1.. and keys L1.., TR1.., P1.., R1.. */
+struct GeneratedInstance {
+  struct TransportResource {
+    int capacity, co2Emissions, cost, speed;
+  };
+  struct Product {
+    int size, value;
+    vector<int> validTR;
+    vector<pair<int, int>> netSupplyDemand; // (location, units), nonzero only
+  };
+  struct Route {
+    int from, to;
+    vector<pair<int, int>> transportResources; // (tr, distance)
+  };
+
+  Settings settings;
+  size_t locations = 0;
+  vector<TransportResource> transportResources;
+  vector<Product> products;
+  vector<Route> routes;
+};
+
+/** generates an instance that is always feasible
+ *
+ *  Locations are random points in a square, distances the rounded euclidean ones. A ring in
+ *  both directions, served by every transport resource, connects all locations; degree random
+ *  routes per location with random subsets of the transport resources come on top. Every product
+ *  is valid on a random nonempty subset of the transport resources, and per product
+ *  terminals * locations random locations are sources or sinks. Supply and demand balance per
+ *  product, as flow conservation is an equality. The same options always give the same
+ *  instance, on every platform.
+ */
+void generate_instance(const GeneratorOptions &options, GeneratedInstance &instance);
+
+/** in the json format of lno_rmp_stdin, on a single line */
+void write_instance_json(ostream &os, const GeneratedInstance &instance);
+
+/** as ASP facts in the format of instance_paper.lp, read by asp_reader.h */
+void write_instance_facts(ostream &os, const GeneratedInstance &instance);
+
+#endif // LNO_INSTANCE_GENERATOR_H
@@ -0,0 +1,263 @@
+//
+// Streaming loader for LNO instances in the json format of lno_rmp_stdin.
+//
+
+#include "instance_loader.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+using namespace std;
+
+namespace {
+
+/** SAX handler filling the domain objects while the parser walks the input
+ *
+ *  Nesting (depth = number of open objects, key[d] = last key seen at depth d):
+ *    1 {settings, locations, transportResources, products, routes}
+ *    2 entity key (or settings field)
+ *    3 entity field
+ *    4 netSupplyDemand location / route transport resource key
+ *    5 route transport resource field (distance)
+ *  Objects are created on first mention, so references may precede definitions.
+ */
+class InstanceSax : public nlohmann::json_sax<json> {
+public:
+  InstanceSax(Arena &arena, LoadedInstance &out) : _arena(arena), _out(out){};
+
+  bool null() override { return true; }
+  bool boolean(bool) override { return true; }
+  bool number_integer(number_integer_t v) override { return number((double)v); }
+  bool number_unsigned(number_unsigned_t v) override { return number((double)v); }
+  bool number_float(number_float_t v, const string_t &) override { return number(v); }
+  bool binary(binary_t &) override { return fail("unexpected binary value"); }
+
+  bool string(string_t &v) override {
+    if (_validTR) {
+      _product->validTR.push_back(lookup(_out.transportResourceKeys, v));
+      return true;
+    }
+    if (_depth != 3)
+      return true;
+
+    const auto &field = _key[3];
+    switch (_section) {
+    case LOCATIONS:
+      if (field == "name") _location->name.assign(v);
+      break;
+    case TRANSPORT_RESOURCES:
+      if (field == "name") _transportResource->name.assign(v);
+      break;
+    case PRODUCTS:
+      if (field == "name") _product->name.assign(v);
+      break;
+    case ROUTES:
+      if (field == "from") _route->from = lookup(_out.locationKeys, v);
+      else if (field == "to") _route->to = lookup(_out.locationKeys, v);
+      break;
+    default:
+      break;
+    }
+    return true;
+  };
+
+  bool start_object(size_t) override {
+    if (++_depth >= MAX_DEPTH)
+      return fail("instance nested too deeply");
+
+    if (_depth == 2)
+      _section = section(_key[1]);
+
+    if (_depth == 3) {
+      const auto &key = _key[2];
+      switch (_section) {
+      case LOCATIONS:
+        _location = define(_out.locationKeys, key);
+        break;
+      case TRANSPORT_RESOURCES:
+        _transportResource = define(_out.transportResourceKeys, key);
+        break;
+      case PRODUCTS:
+        _product = define(_out.productKeys, key);
+        break;
+      case ROUTES:
+        _route = define(_out.routeKeys, key);
+        break;
+      default:
+        break;
+      }
+    }
+
+    if (_depth == 5 && _section == ROUTES && _key[3] == "transportResources")
+      _route->transportResources.emplace_back(lookup(_out.transportResourceKeys, _key[4]), 0.0);
+
+    return true;
+  };
+
+  bool key(string_t &k) override {
+    _key[_depth] = k;
+    return true;
+  };
+
+  bool end_object() override {
+    --_depth;
+    return true;
+  };
+
+  bool start_array(size_t) override {
+    ++_arrays;
+    _validTR = _arrays == 1 && _depth == 3 && _section == PRODUCTS && _key[3] == "validTR";
+    return true;
+  };
+
+  bool end_array() override {
+    --_arrays;
+    _validTR = false;
+    return true;
+  };
+
+  bool parse_error(size_t, const std::string &, const nlohmann::detail::exception &e) override {
+    return fail(e.what());
+  };
+
+  /** orders the objects by key and checks that every reference was defined */
+  bool finish() {
+    if (!collect(_out.locationKeys, _out.locations, "location") ||
+        !collect(_out.transportResourceKeys, _out.transportResources, "transport resource") ||
+        !collect(_out.productKeys, _out.products, "product") ||
+        !collect(_out.routeKeys, _out.routes, "route"))
+      return false;
+
+    for (const auto &route : _out.routes)
+      if (route->from == nullptr || route->to == nullptr)
+        return fail("route without from/to");
+
+    return true;
+  };
+
+  std::string error;
+
+private:
+  enum Section { NONE, SETTINGS, LOCATIONS, TRANSPORT_RESOURCES, PRODUCTS, ROUTES };
+  static const int MAX_DEPTH = 8;
+
+  static Section section(const std::string &key) {
+    if (key == "settings") return SETTINGS;
+    if (key == "locations") return LOCATIONS;
+    if (key == "transportResources") return TRANSPORT_RESOURCES;
+    if (key == "products") return PRODUCTS;
+    if (key == "routes") return ROUTES;
+    return NONE;
+  };
+
+  bool number(double v) {
+    if (_arrays > 0)
+      return true;
+
+    if (_depth == 2 && _section == SETTINGS) {
+      if (_key[2] == "co2Costs") _out.settings.co2Costs = v;
+      else if (_key[2] == "capitalCosts") _out.settings.capitalCosts = v;
+      return true;
+    }
+
+    if (_depth == 3) {
+      const auto &field = _key[3];
+      if (_section == TRANSPORT_RESOURCES) {
+        if (field == "capacity") _transportResource->capacity = v;
+        else if (field == "co2Emissions") _transportResource->co2Emissions = v;
+        else if (field == "cost") _transportResource->cost = v;
+        else if (field == "speed") _transportResource->speed = v;
+      } else if (_section == PRODUCTS) {
+        if (field == "size") _product->size = v;
+        else if (field == "value") _product->value = v;
+      }
+      return true;
+    }
+
+    if (_depth == 4 && _section == PRODUCTS && _key[3] == "netSupplyDemand") {
+      _product->netSupplyDemand[lookup(_out.locationKeys, _key[4])] = (int)v;
+      return true;
+    }
+
+    if (_depth == 5 && _section == ROUTES && _key[3] == "transportResources" && _key[5] == "distance")
+      get<1>(_route->transportResources.back()) = v;
+
+    return true;
+  };
+
+  /** object for a key, created in the arena on first mention */
+  template <class T> T *lookup(unordered_map<string_view, T *> &keys, const std::string &key) {
+    auto it = keys.find(key);
+    if (it != keys.end())
+      return it->second;
+    T *object = _arena.make<T>();
+    keys.emplace(_arena.intern(key), object);
+    return object;
+  };
+
+  template <class T> T *define(unordered_map<string_view, T *> &keys, const std::string &key) {
+    T *object = lookup(keys, key);
+    _defined.insert(object);
+    return object;
+  };
+
+  template <class T>
+  bool collect(const unordered_map<string_view, T *> &keys, vector<T *> &objects, const char *what) {
+    vector<pair<string_view, T *>> sorted(keys.begin(), keys.end());
+    sort(sorted.begin(), sorted.end(),
+         [](const auto &a, const auto &b) { return a.first < b.first; });
+
+    objects.clear();
+    objects.reserve(sorted.size());
+    for (const auto &entry : sorted) {
+      if (_defined.count(entry.second) == 0)
+        return fail(std::string("undefined ") + what + " " + std::string(entry.first));
+      objects.push_back(entry.second);
+    }
+    return true;
+  };
+
+  bool fail(const std::string &message) {
+    error = message;
+    return false;
+  };
+
+  Arena &_arena;
+  LoadedInstance &_out;
+
+  int _depth = 0;
+  int _arrays = 0;
+  bool _validTR = false;
+  std::string _key[MAX_DEPTH + 1];
+  Section _section = NONE;
+
+  Location *_location = nullptr;
+  TransportResource *_transportResource = nullptr;
+  Product *_product = nullptr;
+  Route *_route = nullptr;
+
+  unordered_set<const void *> _defined;
+};
+
+} // namespace
+
+bool load_instance_json(istream &in, Arena &arena, LoadedInstance &instance, string &error) {
+  InstanceSax sax(arena, instance);
+  if (!json::sax_parse(in, &sax) || !sax.finish()) {
+    error = sax.error;
+    return false;
+  }
+  return true;
+}
+
+bool load_instance_json(string_view text, Arena &arena, LoadedInstance &instance, string &error) {
+  InstanceSax sax(arena, instance);
+  if (!json::sax_parse(text.begin(), text.end(), &sax) || !sax.finish()) {
+    error = sax.error;
+    return false;
+  }
+  return true;
+}
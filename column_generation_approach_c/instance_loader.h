@@ -0,0 +1,46 @@
+//
+// Streaming loader for LNO instances in the json format of lno_rmp_stdin.
+//
+
+#ifndef LNO_INSTANCE_LOADER_H
+#define LNO_INSTANCE_LOADER_H
+
+#include <istream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "arena.h"
+#include "main.h"
+
+using namespace std;
+
+/** domain objects of a loaded instance, all allocated in the arena passed to the loader
+ *
+ *  Each vector is ordered by json key, the order nlohmann::json iterates objects in, so the
+ *  dense ids match the ones the controller derives from the sorted keys.
+ */
+struct LoadedInstance {
+  Settings settings;
+  vector<Location *> locations;
+  vector<TransportResource *> transportResources;
+  vector<Product *> products;
+  vector<Route *> routes;
+
+  /* json key -> object, the keys themselves live in the arena */
+  unordered_map<string_view, Location *> locationKeys;
+  unordered_map<string_view, TransportResource *> transportResourceKeys;
+  unordered_map<string_view, Product *> productKeys;
+  unordered_map<string_view, Route *> routeKeys;
+};
+
+/** parses an instance in a single pass over the input with nlohmann's SAX interface
+ *
+ *  Sections and references may appear in any order. Returns false and sets error if
+ *  the input is malformed or refers to undefined locations or transport resources.
+ */
+bool load_instance_json(istream &in, Arena &arena, LoadedInstance &instance, string &error);
+bool load_instance_json(string_view text, Arena &arena, LoadedInstance &instance, string &error);
+
+#endif // LNO_INSTANCE_LOADER_H
@@ -0,0 +1,68 @@
+//
+// Lean model build: nameless SCIP entities and memory-conscious SCIP settings.
+//
+
+#include "lean.h"
+
+EntityNames::EntityNames(const Instance &instance, bool lean) : _instance(instance), _lean(lean) {
+  _buffer[0] = '\0';
+}
+
+const char *EntityNames::name(const Entity &entity) { return _lean ? "" : format(entity); }
+
+void EntityNames::record(SCIP_VAR *var, const Entity &entity) {
+  if (_lean)
+    _vars.emplace_back(var, entity);
+}
+
+void EntityNames::print_solution(SCIP *scip, SCIP_SOL *sol, ostream &os) {
+  if (sol == nullptr) {
+    os << "no solution available" << endl;
+    return;
+  }
+  os << "objective value: " << SCIPgetSolOrigObj(scip, sol) << "\n";
+  for (const auto &[var, entity] : _vars) {
+    const double value = SCIPgetSolVal(scip, sol, var);
+    if (!SCIPisZero(scip, value))
+      os << format(entity) << " " << value << "\n";
+  }
+  os.flush();
+}
+
+const char *EntityNames::format(const Entity &entity) {
+  const Route *route = _instance.routes[entity.a];
+  const char *from = route->from->name.c_str(), *to = route->to->name.c_str();
+  switch (entity.kind) {
+  case EntityKind::Flow:
+    (void)SCIPsnprintf(_buffer, 255, "flow_%s->%s_%s", from, to, _instance.products[entity.b]->name.c_str());
+    break;
+  case EntityKind::InitialY:
+    (void)SCIPsnprintf(_buffer, 255, "initial-y_%s->%s_%s", from, to, _instance.products[entity.b]->name.c_str());
+    break;
+  case EntityKind::Demand:
+    (void)SCIPsnprintf(_buffer, 255, "demand_%s->%s_%s", from, to, _instance.products[entity.b]->name.c_str());
+    break;
+  case EntityKind::Packing:
+    (void)SCIPsnprintf(_buffer, 255, "packing_%s->%s_%s_%u", from, to,
+                       _instance.transportResources[entity.b]->name.c_str(), entity.c);
+    break;
+  }
+  return _buffer;
+}
+
+SCIP_RETCODE set_lean_parameters(SCIP *scip, double memoryLimit) {
+  /* names are empty, so the hash tables over them would only cost memory */
+  SCIP_CALL(SCIPsetBoolParam(scip, "misc/usevartable", FALSE));
+  SCIP_CALL(SCIPsetBoolParam(scip, "misc/useconstable", FALSE));
+  SCIP_CALL(SCIPsetBoolParam(scip, "misc/usesmalltables", TRUE));
+
+  SCIP_CALL(SCIPsetBoolParam(scip, "lp/freesolvalbuffers", TRUE));
+  SCIP_CALL(SCIPsetBoolParam(scip, "lp/cleanupcols", TRUE));
+  SCIP_CALL(SCIPsetBoolParam(scip, "lp/cleanupcolsroot", TRUE));
+  SCIP_CALL(SCIPsetBoolParam(scip, "conflict/enable", FALSE));
+
+  if (memoryLimit > 0)
+    SCIP_CALL(SCIPsetRealParam(scip, "limits/memory", memoryLimit));
+
+  return SCIP_OKAY;
+}
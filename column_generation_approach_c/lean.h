@@ -0,0 +1,66 @@
+//
+// Lean model build: nameless SCIP entities and memory-conscious SCIP settings.
+//
+
+#ifndef LNO_LEAN_H
+#define LNO_LEAN_H
+
+#include <cstdint>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include "objscip/objscip.h"
+
+#include "instance.h"
+
+using namespace std;
+
+/** the model entity a SCIP variable or constraint stands for */
+enum class EntityKind : uint8_t { Flow, InitialY, Demand, Packing };
+
+/** kind and dense indices: (route, product) for flow, y and demand, (route, tr, number) for packings */
+struct Entity {
+  EntityKind kind;
+  uint32_t a = 0;
+  uint32_t b = 0;
+  uint32_t c = 0;
+};
+
+/** names of the model's variables and constraints
+ *
+ *  By default every entity is created with its full name, e.g. flow_l1->l2_p1. In lean mode it
+ *  is created with an empty name instead, and for variables only the entity is recorded (24
+ *  bytes, no string in SCIP's block memory or name tables); names are built again on demand
+ *  for debug output.
+ */
+class EntityNames {
+public:
+  EntityNames(const Instance &instance, bool lean);
+
+  bool lean() const { return _lean; }
+
+  /** the name to create the entity with, "" in lean mode; valid until the next call */
+  const char *name(const Entity &entity);
+
+  /** remembers what a created variable stands for, lean mode only */
+  void record(SCIP_VAR *var, const Entity &entity);
+
+  /** the nonzero values of a solution over all recorded variables, with their full names */
+  void print_solution(SCIP *scip, SCIP_SOL *sol, ostream &os);
+
+private:
+  const char *format(const Entity &entity);
+
+  const Instance &_instance;
+  bool _lean;
+  vector<pair<SCIP_VAR *, Entity>> _vars;
+  char _buffer[255];
+};
+
+/** SCIP settings for large models: no name hash tables, LP buffers freed after each solve,
+ *  no conflict analysis, unused columns cleaned from the LP; memoryLimit in MB, 0 = none
+ */
+SCIP_RETCODE set_lean_parameters(SCIP *scip, double memoryLimit = 0);
+
+#endif // LNO_LEAN_H
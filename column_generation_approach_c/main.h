@@ -8,9 +8,15 @@
 #include <iostream>
 #include <vector>
 #include <map>
+#include <memory_resource>
+#include <tuple>
 
 using namespace std;
 
+/* The domain objects keep their strings and containers in a memory resource so an
+ * instance loader can place everything in one arena (see arena.h). Without one they
+ * use the default heap resource. */
+
 struct Settings {
   double co2Costs;
   double capitalCosts;
@@ -21,54 +27,110 @@ struct Settings {
   };
 };
 
+/* The fact format carries no settings, every reader of it uses these (as controller.py::facts_to_json). */
+inline const Settings FACT_FORMAT_SETTINGS(50.0, 0.1);
+
 struct Location {
-  string name;
+  pmr::string name;
+  int id = -1; // dense index, assigned by build_instance
 
-  explicit Location(string name) { this->name = std::move(name); };
+  explicit Location(const string &name,
+                    pmr::memory_resource *mr = pmr::get_default_resource())
+      : name(name, mr){};
+  explicit Location(pmr::memory_resource *mr) : name(mr){};
 };
 
 struct TransportResource {
-  string name;
-  double capacity;
-  double co2Emissions;
-  double cost;
-  double speed;
-
-  TransportResource(string name, double capacity, double co2Emissions,
-                    double cost, double speed) {
-    this->name = std::move(name);
+  pmr::string name;
+  int id = -1; // dense index, assigned by build_instance
+  double capacity = 0;
+  double co2Emissions = 0;
+  double cost = 0;
+  double speed = 0;
+
+  TransportResource(const string &name, double capacity, double co2Emissions,
+                    double cost, double speed,
+                    pmr::memory_resource *mr = pmr::get_default_resource())
+      : name(name, mr) {
     this->capacity = capacity;
     this->co2Emissions = co2Emissions;
     this->cost = cost;
     this->speed = speed;
   };
+  explicit TransportResource(pmr::memory_resource *mr) : name(mr){};
 };
 
 struct Product {
-  string name;
-  vector<TransportResource *> validTR;
-  double size;
-  double value;
-  map<Location *, int> netSupplyDemand;
-
-  Product(string name, vector<TransportResource *> validTR, double size, double value, map<Location *, int> netSupplyDemand) {
-        this->name = std::move(name);
+  pmr::string name;
+  int id = -1; // dense index, assigned by build_instance
+  pmr::vector<TransportResource *> validTR;
+  double size = 0;
+  double value = 0;
+  pmr::map<Location *, int> netSupplyDemand;
+
+  Product(const string &name, const vector<TransportResource *> &validTR, double size, double value,
+          const map<Location *, int> &netSupplyDemand,
+          pmr::memory_resource *mr = pmr::get_default_resource())
+      : name(name, mr), validTR(validTR.begin(), validTR.end(), mr),
+        netSupplyDemand(netSupplyDemand.begin(), netSupplyDemand.end(), mr) {
         this->size = size;
         this->value = value;
-        this->validTR = std::move(validTR);
-        this->netSupplyDemand = netSupplyDemand;
     };
+  explicit Product(pmr::memory_resource *mr) : name(mr), validTR(mr), netSupplyDemand(mr){};
 };
 
 struct Route {
-  Location *to;
-  Location *from;
-  vector<tuple<TransportResource*, double>> transportResources;
+  int id = -1; // dense index, assigned by build_instance
+  Location *to = nullptr;
+  Location *from = nullptr;
+  pmr::vector<tuple<TransportResource*, double>> transportResources;
 
-  Route(Location *to, Location *from, vector<tuple<TransportResource*, double>> transportResources) {
+  Route(Location *to, Location *from, const vector<tuple<TransportResource*, double>> &transportResources,
+        pmr::memory_resource *mr = pmr::get_default_resource())
+      : transportResources(transportResources.begin(), transportResources.end(), mr) {
     this->to = to;
     this->from = from;
-    this->transportResources = transportResources;
+  };
+  explicit Route(pmr::memory_resource *mr) : transportResources(mr){};
+};
+
+/** CSR-style route incidence per location, indices are dense location and
+ *  route ids: the routes leaving location l are
+ *  outRoutes[outStart[l] .. outStart[l+1]), the ones entering it likewise.
+ *  A route from a location to itself only counts as leaving it.
+ */
+struct LocationIncidence {
+  vector<size_t> outStart;
+  vector<size_t> outRoutes;
+  vector<size_t> inStart;
+  vector<size_t> inRoutes;
+
+  LocationIncidence() = default;
+
+  /** from[r] and to[r] are the location ids of route r */
+  LocationIncidence(size_t nLocations, const vector<int> &from, const vector<int> &to) {
+    // counting sort of the routes by tail and by head location
+    outStart.assign(nLocations + 1, 0);
+    inStart.assign(nLocations + 1, 0);
+    for (size_t r = 0; r < from.size(); ++r) {
+      ++outStart[from[r] + 1];
+      if (to[r] != from[r])
+        ++inStart[to[r] + 1];
+    }
+    for (size_t l = 0; l < nLocations; ++l) {
+      outStart[l + 1] += outStart[l];
+      inStart[l + 1] += inStart[l];
+    }
+
+    outRoutes.resize(outStart.back());
+    inRoutes.resize(inStart.back());
+    vector<size_t> outPos(outStart.begin(), outStart.end() - 1);
+    vector<size_t> inPos(inStart.begin(), inStart.end() - 1);
+    for (size_t r = 0; r < from.size(); ++r) {
+      outRoutes[outPos[from[r]]++] = r;
+      if (to[r] != from[r])
+        inRoutes[inPos[to[r]]++] = r;
+    }
   };
 };
 
@@ -0,0 +1,284 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "rmp_core.h"
+#include "dual_io.h"
+#include "column_generation.h"
+#include "instance_loader.h"
+#include "asp_reader.h"
+#include "instance_generator.h"
+#include "stats.h"
+using namespace std;
+using json = nlohmann::json;
+
+// Phase timings of the C++ pipeline per instance, repeated to get stable percentiles.
+//   load      json (SAX) or ASP facts (mmap) into the arena
+//   build     build_instance + RmpSession::init, the model solve_rmp_from_data builds
+//   lp        first LP solve of the initial RMP
+//   duals     text dual block (print_duals) as consumed by controller.py
+//   pricing   every pricing call of the column generation run, over all repetitions
+//   cg        end to end column generation from a fresh session
+// Output is json; with --baseline the medians are compared and regressions fail the run.
+//
+// With --scaling the instances are generated (instance_generator.h) with one dimension growing
+// geometrically, one run per step:
+//   load      the generated json from memory
+//   instance  build_instance, the dense O(L*P + R*P) arrays
+//   init      RmpSession::init, the LP build
+//   lp        first LP solve, with its simplex iterations
+//   cg        column generation from a fresh session (--cg only)
+// and the peak RSS after the step. Steps run smallest first, so the process-wide peak is the one
+// of the latest step. Growth stops after the last step or once a step took more than --max-seconds.
+
+using Clock = chrono::steady_clock;
+static double since(Clock::time_point t) { return chrono::duration<double>(Clock::now() - t).count(); }
+
+static bool load_any(const string& path, Arena& arena, LoadedInstance& li){
+  string error;
+  bool ok;
+  if (path.size()>3 && path.compare(path.size()-3, 3, ".lp")==0) ok = load_instance_asp(path.c_str(), FACT_FORMAT_SETTINGS, arena, li, error);
+  else { ifstream in(path); ok = in && load_instance_json(in, arena, li, error); if (!in) error = "cannot open"; }
+  if (!ok) cerr << path << ": " << error << "\n";
+  return ok;
+}
+
+// nearest-rank percentile of sorted samples
+static double percentile(const vector<double>& sorted, double q){
+  if (sorted.empty()) return 0.0;
+  size_t k = (size_t)ceil(q*sorted.size());
+  return sorted[min(sorted.size()-1, k>0 ? k-1 : 0)];
+}
+
+static json summary(vector<double> samples){
+  sort(samples.begin(), samples.end());
+  double sum = 0.0; for (double s: samples) sum += s;
+  return json{{"n", samples.size()},
+              {"median", percentile(samples, 0.5)}, {"p10", percentile(samples, 0.1)}, {"p90", percentile(samples, 0.9)},
+              {"p99", percentile(samples, 0.99)},
+              {"min", samples.empty() ? 0.0 : samples.front()}, {"max", samples.empty() ? 0.0 : samples.back()},
+              {"mean", samples.empty() ? 0.0 : sum/samples.size()}};
+}
+
+static bool bench_scaling_step(const GeneratorOptions& generator, bool cg, const ColumnGenerationOptions& options,
+                               const char* keepPrefix, json& out){
+  GeneratedInstance generated;
+  generate_instance(generator, generated);
+  ostringstream text; write_instance_json(text, generated);
+  const string jsonText = text.str();
+  if (keepPrefix) {
+    ostringstream name;
+    name << keepPrefix << "_L" << generator.locations << "_P" << generator.products << "_T"
+         << generator.transportResources << "_d" << generator.degree;
+    const string base = name.str();
+    ofstream(base + ".json") << jsonText;
+    ofstream facts(base + ".lp"); write_instance_facts(facts, generated);
+  }
+
+  json phases = json::object();
+  auto t0 = Clock::now();
+  Arena arena; LoadedInstance li; string error;
+  if (!load_instance_json(string_view(jsonText), arena, li, error)) { cerr << "generated instance: " << error << "\n"; return false; }
+  phases["load"] = since(t0);
+
+  t0 = Clock::now();
+  Instance instance = build_instance(li.settings, li.locations, li.transportResources, li.products, li.routes);
+  phases["instance"] = since(t0);
+
+  t0 = Clock::now();
+  RmpSession session(instance);
+  if (session.init()!=SCIP_OKAY) return false;
+  phases["init"] = since(t0);
+
+  t0 = Clock::now();
+  if (session.solve()!=SCIP_OKAY || !session.optimal()) { cerr << "generated instance: RMP not optimal\n"; return false; }
+  phases["lp"] = since(t0);
+
+  out = json{{"locations", instance.L}, {"products", instance.P}, {"transportResources", instance.T},
+             {"routes", instance.R}, {"slots", instance.routeTR.size()}, {"pairs", instance.R*instance.P},
+             {"jsonBytes", jsonText.size()}, {"lpIterations", session.iterations()}, {"objective", session.objective()}};
+
+  if (cg) {
+    t0 = Clock::now();
+    WorkStealingPool pool(options.pricing.threads);
+    RmpSession cgSession(instance);
+    ColumnGenerationResult result;
+    if (cgSession.init(options.stabilization.boxStep, !options.farkas)!=SCIP_OKAY ||
+        run_column_generation(cgSession, options, pool, result)!=SCIP_OKAY) return false;
+    phases["cg"] = since(t0);
+    out["cg"] = json{{"objective", result.objective}, {"rounds", result.rounds}, {"columns", result.columns},
+                     {"lpIterations", result.lpIterations}};
+  }
+  out["seconds"] = phases;
+  out["peakRssBytes"] = peak_rss_bytes();
+  return true;
+}
+
+static bool known_dimension(const string& dimension){
+  return dimension=="locations" || dimension=="products" || dimension=="trs" || dimension=="degree";
+}
+
+// grows the dimension from..to by factor, the other dimensions stay at the generator options;
+// main has checked the dimension and the range
+static bool bench_scaling(const string& dimension, double from, double to, double factor, GeneratorOptions generator,
+                          bool cg, const ColumnGenerationOptions& options, double maxSeconds, const char* keepPrefix,
+                          json& out){
+  out = json::array();
+  for (double value=from; value<=to*(1+1e-9); value*=factor) {
+    if (dimension=="locations") generator.locations = (size_t)llround(value);
+    else if (dimension=="products") generator.products = (size_t)llround(value);
+    else if (dimension=="trs") generator.transportResources = (size_t)llround(value);
+    else generator.degree = value;
+
+    json step;
+    if (!bench_scaling_step(generator, cg, options, keepPrefix, step)) return false;
+    double total = 0.0;
+    for (auto& [phase, seconds]: step["seconds"].items()) total += seconds.get<double>();
+    cerr << dimension << " " << value << ": " << total << "s, peak RSS " << step["peakRssBytes"].get<long>() << " bytes\n";
+    out.push_back(step);
+    if (maxSeconds > 0 && total > maxSeconds) break;
+    if (factor <= 1.0) break;
+  }
+  return true;
+}
+
+static bool bench_instance(const string& path, size_t reps, const ColumnGenerationOptions& options, json& out){
+  map<string, vector<double>> t;
+  double objective = 0.0; size_t rounds = 0, columns = 0;
+  WorkStealingPool pool(options.pricing.threads);
+
+  for (size_t rep=0; rep<reps; ++rep) {
+    auto t0 = Clock::now();
+    Arena arena; LoadedInstance li;
+    if (!load_any(path, arena, li)) return false;
+    t["load"].push_back(since(t0));
+
+    t0 = Clock::now();
+    Instance instance = build_instance(li.settings, li.locations, li.transportResources, li.products, li.routes);
+    RmpSession session(instance);
+    if (session.init()!=SCIP_OKAY) return false;
+    t["build"].push_back(since(t0));
+
+    t0 = Clock::now();
+    if (session.solve()!=SCIP_OKAY || !session.optimal()) { cerr << path << ": RMP not optimal\n"; return false; }
+    t["lp"].push_back(since(t0));
+
+    t0 = Clock::now();
+    ostringstream duals; session.print_duals(duals);
+    t["duals"].push_back(since(t0));
+
+    t0 = Clock::now();
+    RmpSession cgSession(instance);
+    ColumnGenerationResult result;
+    if (cgSession.init(options.stabilization.boxStep, !options.farkas)!=SCIP_OKAY ||
+        run_column_generation(cgSession, options, pool, result)!=SCIP_OKAY) return false;
+    t["cg"].push_back(since(t0));
+
+    auto& pricing = t["pricing"];
+    pricing.insert(pricing.end(), result.pricingSeconds.begin(), result.pricingSeconds.end());
+    objective = result.objective; rounds = result.rounds; columns = result.columns;
+  }
+
+  json phases = json::object();
+  for (auto& [phase, samples]: t) phases[phase] = summary(samples);
+  out = json{{"phases", phases}, {"objective", objective}, {"rounds", rounds}, {"columns", columns}};
+  return true;
+}
+
+// compares medians; phases below minTime are too noisy to judge and only reported
+static bool compare(const json& current, const json& baseline, double tolerance, double minTime){
+  bool ok = true;
+  for (auto& [instance, data]: current["instances"].items()) {
+    if (!baseline["instances"].contains(instance)) continue;
+    const json& base = baseline["instances"][instance]["phases"];
+    for (auto& [phase, stats]: data["phases"].items()) {
+      if (!base.contains(phase)) continue;
+      const double now = stats["median"], was = base[phase]["median"];
+      const double ratio = was>0 ? now/was : 1.0;
+      const bool regressed = ratio > 1.0+tolerance && now >= minTime;
+      cerr << (regressed ? "REGRESSION " : "ok         ") << instance << " " << phase
+           << " median " << now << "s baseline " << was << "s ratio " << ratio << "\n";
+      ok = ok && !regressed;
+    }
+  }
+  return ok;
+}
+
+// usage: lno_bench [--reps N] [--threads N] [--out file.json] [--baseline file.json]
+//                  [--tolerance 0.1] [--min-time 1e-4] instance...
+//        lno_bench --scaling <locations|products|trs|degree> <from> <to> [--factor 2] [--cg] [--threads N]
+//                  [--max-seconds s] [--keep <prefix>] [--out file.json]
+//                  [--locations N] [--products P] [--trs T] [--degree d] [--terminals share] [--imbalance f] [--seed s]
+int main(int argc, char** argv){
+  size_t reps = 10;
+  double tolerance = 0.10, minTime = 1e-4;
+  const char* outPath = nullptr; const char* baselinePath = nullptr;
+  ColumnGenerationOptions options;
+  vector<string> instances;
+  string scaling;
+  double from = 0, to = 0, factor = 2.0, maxSeconds = 0;
+  bool cg = false;
+  const char* keepPrefix = nullptr;
+  GeneratorOptions generator;
+  for (int i=1; i<argc; ++i) {
+    if (strcmp(argv[i], "--scaling")==0 && i+3<argc) { scaling = argv[++i]; from = atof(argv[++i]); to = atof(argv[++i]); }
+    else if (strcmp(argv[i], "--factor")==0 && i+1<argc) factor = atof(argv[++i]);
+    else if (strcmp(argv[i], "--cg")==0) cg = true;
+    else if (strcmp(argv[i], "--max-seconds")==0 && i+1<argc) maxSeconds = atof(argv[++i]);
+    else if (strcmp(argv[i], "--keep")==0 && i+1<argc) keepPrefix = argv[++i];
+    else if (strcmp(argv[i], "--locations")==0 && i+1<argc) generator.locations = (size_t)atol(argv[++i]);
+    else if (strcmp(argv[i], "--products")==0 && i+1<argc) generator.products = (size_t)atol(argv[++i]);
+    else if (strcmp(argv[i], "--trs")==0 && i+1<argc) generator.transportResources = (size_t)atol(argv[++i]);
+    else if (strcmp(argv[i], "--degree")==0 && i+1<argc) generator.degree = atof(argv[++i]);
+    else if (strcmp(argv[i], "--terminals")==0 && i+1<argc) generator.terminals = atof(argv[++i]);
+    else if (strcmp(argv[i], "--imbalance")==0 && i+1<argc) generator.imbalance = atof(argv[++i]);
+    else if (strcmp(argv[i], "--seed")==0 && i+1<argc) generator.seed = strtoull(argv[++i], nullptr, 10);
+    else if (strcmp(argv[i], "--reps")==0 && i+1<argc) reps = (size_t)atoi(argv[++i]);
+    else if (strcmp(argv[i], "--threads")==0 && i+1<argc) options.pricing.threads = (size_t)atoi(argv[++i]);
+    else if (strcmp(argv[i], "--out")==0 && i+1<argc) outPath = argv[++i];
+    else if (strcmp(argv[i], "--baseline")==0 && i+1<argc) baselinePath = argv[++i];
+    else if (strcmp(argv[i], "--tolerance")==0 && i+1<argc) tolerance = atof(argv[++i]);
+    else if (strcmp(argv[i], "--min-time")==0 && i+1<argc) minTime = atof(argv[++i]);
+    else if (argv[i][0]=='-') { cerr << "unknown argument " << argv[i] << "\n"; return 1; }
+    else instances.push_back(argv[i]);
+  }
+  if (!scaling.empty()) {
+    if (!known_dimension(scaling)) { cerr << "unknown dimension " << scaling << " (locations, products, trs, degree)\n"; return 1; }
+    if (from <= 0 || to < from) { cerr << "--scaling needs 0 < from <= to\n"; return 1; }
+    if (generator.imbalance < 0 || generator.imbalance >= 1) { cerr << "--imbalance must be in [0, 1)\n"; return 1; }
+    json steps;
+    if (!bench_scaling(scaling, from, to, factor, generator, cg, options, maxSeconds, keepPrefix, steps)) return 1;
+    json report{{"version", 1}, {"scaling", scaling}, {"factor", factor}, {"seed", generator.seed},
+                {"threads", options.pricing.threads}, {"steps", steps}};
+    if (outPath) { ofstream out(outPath); out << report.dump(2) << "\n"; }
+    else cout << report.dump(2) << "\n";
+    return 0;
+  }
+  if (instances.empty() || reps==0) { cerr << "usage: lno_bench [--reps N] [--threads N] [--out f] [--baseline f] instance...\n"; return 1; }
+
+  json report{{"version", 1}, {"repetitions", reps}, {"threads", options.pricing.threads}, {"instances", json::object()}};
+  for (const auto& path: instances) {
+    json result;
+    if (!bench_instance(path, reps, options, result)) return 1;
+    report["instances"][path] = result;
+  }
+
+  if (outPath) { ofstream out(outPath); out << report.dump(2) << "\n"; }
+  else cout << report.dump(2) << "\n";
+
+  if (baselinePath) {
+    ifstream in(baselinePath);
+    json baseline = json::parse(in, nullptr, false);
+    if (baseline.is_discarded()) { cerr << "cannot read baseline " << baselinePath << "\n"; return 1; }
+    return compare(report, baseline, tolerance, minTime) ? 0 : 2;
+  }
+  return 0;
+}
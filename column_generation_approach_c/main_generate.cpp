@@ -0,0 +1,47 @@
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "instance_generator.h"
+using namespace std;
+
+// Synthetic instances for scaling experiments, see instance_generator.h. The json goes to
+// lno_rmp_stdin / lno_bench, the facts to restricted_master_problem or the ASP encodings.
+// usage: lno_generate [--locations N] [--products P] [--trs T] [--degree d] [--terminals share]
+//                     [--imbalance f] [--seed s] [--co2 c] [--capital k] [--facts] [--out file]
+int main(int argc, char** argv){
+  GeneratorOptions options;
+  bool facts = false;
+  const char* outPath = nullptr;
+  for (int i=1; i<argc; ++i) {
+    if (strcmp(argv[i], "--locations")==0 && i+1<argc) options.locations = (size_t)atol(argv[++i]);
+    else if (strcmp(argv[i], "--products")==0 && i+1<argc) options.products = (size_t)atol(argv[++i]);
+    else if (strcmp(argv[i], "--trs")==0 && i+1<argc) options.transportResources = (size_t)atol(argv[++i]);
+    else if (strcmp(argv[i], "--degree")==0 && i+1<argc) options.degree = atof(argv[++i]);
+    else if (strcmp(argv[i], "--terminals")==0 && i+1<argc) options.terminals = atof(argv[++i]);
+    else if (strcmp(argv[i], "--imbalance")==0 && i+1<argc) options.imbalance = atof(argv[++i]);
+    else if (strcmp(argv[i], "--seed")==0 && i+1<argc) options.seed = strtoull(argv[++i], nullptr, 10);
+    else if (strcmp(argv[i], "--co2")==0 && i+1<argc) options.settings.co2Costs = atof(argv[++i]);
+    else if (strcmp(argv[i], "--capital")==0 && i+1<argc) options.settings.capitalCosts = atof(argv[++i]);
+    else if (strcmp(argv[i], "--facts")==0) facts = true;
+    else if (strcmp(argv[i], "--out")==0 && i+1<argc) outPath = argv[++i];
+    else { cerr << "unknown argument " << argv[i] << "\n"; return 1; }
+  }
+  if (options.imbalance < 0 || options.imbalance >= 1) { cerr << "--imbalance must be in [0, 1)\n"; return 1; }
+
+  GeneratedInstance instance;
+  generate_instance(options, instance);
+
+  ofstream file;
+  if (outPath) {
+    file.open(outPath);
+    if (!file) { cerr << "Cannot open " << outPath << "\n"; return 1; }
+  }
+  ostream& out = outPath ? file : cout;
+  if (facts) write_instance_facts(out, instance);
+  else write_instance_json(out, instance);
+  cerr << "generated " << instance.locations << " locations, " << instance.routes.size() << " routes, "
+       << instance.products.size() << " products, " << instance.transportResources.size() << " transport resources\n";
+  return out ? 0 : 1;
+}
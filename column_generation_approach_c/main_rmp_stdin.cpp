@@ -1,80 +1,443 @@
 #include <iostream>
 #include <sstream>
-#include <unordered_map>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <fstream>
 #include "rmp_core.h"
-#include <nlohmann/json.hpp>
-using json = nlohmann::json;
+#include "column_generation.h"
+#include "primal_heuristic.h"
+#include "greedy_start.h"
+#include "batch.h"
+#include "dual_io.h"
+#include "instance_loader.h"
+#include "asp_reader.h"
+#include "presolve.h"
+#include "replan.h"
+#include "snapshot.h"
+#include "sweep.h"
+#ifdef LNO_WITH_CLINGO
+#include <memory>
+#include "asp_pricing.h"
+#endif
 using namespace std;
 
-// same object wiring as your old read_problem(), but fed by an in-memory json
-static void build_from_json(
-  const json& data,
-  Settings& settings,
-  vector<Location*>& locations,
-  vector<TransportResource*>& trs,
-  vector<Product*>& products,
-  vector<Route*>& routes)
-{
-  struct Lk { unordered_map<string,Location*> loc;
-              unordered_map<string,TransportResource*> tr;
-              unordered_map<string,Product*> prod;
-              unordered_map<string,Route*> route; } lk;
-
-  settings.co2Costs     = data.at("settings").at("co2Costs");
-  settings.capitalCosts = data.at("settings").at("capitalCosts");
-
-  for (auto it=data.at("locations").begin(); it!=data.at("locations").end(); ++it){
-    auto* L = new Location(it.value().at("name"));
-    lk.loc[it.key()] = L; locations.push_back(L);
-  }
-  for (auto it=data.at("transportResources").begin(); it!=data.at("transportResources").end(); ++it){
-    auto* T = new TransportResource(it.value().at("name"),
-                                    it.value().at("capacity"),
-                                    it.value().at("co2Emissions"),
-                                    it.value().at("cost"),
-                                    it.value().at("speed"));
-    lk.tr[it.key()] = T; trs.push_back(T);
-  }
-  for (auto it=data.at("products").begin(); it!=data.at("products").end(); ++it){
-    vector<TransportResource*> valid;
-    for (auto& trId: it.value().at("validTR")) valid.push_back(lk.tr.at(trId));
-
-    map<Location*,int> nsd;
-    for (auto jt=it.value().at("netSupplyDemand").begin(); jt!=it.value().at("netSupplyDemand").end(); ++jt)
-      nsd[ lk.loc.at(jt.key()) ] = jt.value();
-
-    auto* P = new Product(it.value().at("name"), valid,
-                          it.value().at("size"), it.value().at("value"), nsd);
-    lk.prod[it.key()] = P; products.push_back(P);
-  }
-  for (auto it=data.at("routes").begin(); it!=data.at("routes").end(); ++it){
-    vector<tuple<TransportResource*, double>> perTR;
-    for (auto jt=it.value().at("transportResources").begin(); jt!=it.value().at("transportResources").end(); ++jt)
-      perTR.push_back( make_tuple(lk.tr.at(jt.key()), jt.value().at("distance")) );
-    auto* R = new Route( lk.loc.at( it.value().at("to") ),
-                         lk.loc.at( it.value().at("from") ),
-                         perTR );
-    lk.route[it.key()] = R; routes.push_back(R);
+// single-pass load of a json instance; domain objects and names live in the arena
+static bool load(istream& in, Arena& arena, LoadedInstance& li){
+  string error;
+  if (!load_instance_json(in, arena, li, error)) { cerr << "Error reading instance: " << error << "\n"; return false; }
+  return true;
+}
+
+// ASP fact file read directly (mmap), same defaults as controller.py::facts_to_json
+static bool load_facts(const char* path, Arena& arena, LoadedInstance& li){
+  string error;
+  if (!load_instance_asp(path, FACT_FORMAT_SETTINGS, arena, li, error)) { cerr << "Error reading facts: " << error << "\n"; return false; }
+  return true;
+}
+
+// how the duals leave the process
+struct DualOutput {
+  enum { Text, Binary, Mmap } mode = Text;
+  const char* path = nullptr;  // Mmap target
+};
+
+static SCIP_RETCODE emit_duals(const RmpSession& session, const DualOutput& out){
+  switch (out.mode) {
+    case DualOutput::Binary: return write_duals_binary(cout, session);
+    case DualOutput::Mmap:   return write_duals_mmap(out.path, session);
+    default:                 session.print_duals(cout); return SCIP_OKAY;
   }
 }
 
-int main(){
+// Session mode: the first stdin line is the instance json (unless --facts is given), every further line a command
+//   column <routeId> <trId> <prodId>=<count> ...   -> "COLUMN <id>"
+//   remove <id> ...
+//   solve                                          -> "OBJ <value> ITER <pivots>" + duals
+//   cg                                             -> "CG OBJ <value> ROUNDS <n> COLUMNS <k> ITER <pivots>" + duals
+//   supply <locId> <prodId> <value>                   net supply (> 0) or demand (< 0)
+//   route <routeId> on|off
+//   tr <trId> on|off
+//   settings <co2Costs> <capitalCosts>
+//   quit
+// The RMP is built once; each solve warm-starts from the previous basis. The replanning
+// commands (supply, route, tr, settings) change it in place, see replan.h; failures go to stderr.
+static int run_session(const DualOutput& dualOut, const char* factsPath, bool presolve,
+                       const ColumnGenerationOptions& cgOptions){
+  string line;
+  Arena arena;
+  LoadedInstance li;
+  if (factsPath) {
+    if (!load_facts(factsPath, arena, li)) return 1;
+  } else {
+    if (!getline(cin, line)) return 1;
+    istringstream instanceIn(line);
+    if (!load(instanceIn, arena, li)) return 1;
+  }
+
+  Instance instance = build_instance(li.settings, li.locations, li.transportResources, li.products, li.routes);
+  if (presolve) print_presolve_stats(cerr, presolve_instance(instance));
+  RmpSession session(instance);
+  if (session.init(cgOptions.stabilization.boxStep, !cgOptions.farkas)!=SCIP_OKAY) return 1;
+  Replanner replanner(instance, session);
+  WorkStealingPool pool(cgOptions.pricing.threads);
+
+  // id of a keyed object, -1 (and a message) if the key is unknown
+  auto idOf = [](const auto& keys, const string& key, const char* what) {
+    auto it = keys.find(key);
+    if (it == keys.end()) { cerr << "unknown " << what << " " << key << "\n"; return -1; }
+    return it->second->id;
+  };
+  // 1 for on, 0 for off, -1 (and a message) for anything else
+  auto onOff = [](const string& cmd, const string& arg) {
+    if (arg=="on" || arg=="off") return arg=="on" ? 1 : 0;
+    cerr << cmd << " needs on|off, got '" << arg << "'\n";
+    return -1;
+  };
+
+  while (getline(cin, line)) {
+    istringstream in(line);
+    string cmd; in >> cmd;
+    if (cmd.empty()) continue;
+    if (cmd=="quit") break;
+
+    if (cmd=="column") {
+      string routeId, trId, item;
+      if (!(in >> routeId >> trId)) { cerr << "column needs <routeId> <trId> <prodId>=<count> ...\n"; continue; }
+      Packing packing{};
+      packing.route = idOf(li.routeKeys, routeId, "route");
+      packing.transportResource = idOf(li.transportResourceKeys, trId, "transport resource");
+      bool valid = packing.route>=0 && packing.transportResource>=0;
+      for (size_t k=valid ? instance.routeTRStart[packing.route] : 0; valid && k<instance.routeTRStart[packing.route+1]; ++k)
+        if (instance.routeTR[k]==packing.transportResource) packing.distance = instance.routeDistance[k];
+      while (valid && in >> item) {
+        const auto eq = item.find('=');
+        const int product = eq==string::npos ? -1 : idOf(li.productKeys, item.substr(0,eq), "product");
+        char* end = nullptr;
+        const long count = eq==string::npos ? 0 : strtol(item.c_str()+eq+1, &end, 10);
+        if (product<0 || end==item.c_str()+eq+1 || *end || count<=0) {
+          cerr << "column: bad item '" << item << "', expected <prodId>=<count>\n";
+          valid = false;
+        }
+        else packing.items.emplace_back(product, (int)count);
+      }
+      if (!valid) continue;
+      packing.cost = packing_cost(instance, packing.transportResource, packing.distance, packing.items);
+      int id=-1;
+      if (session.add_column(packing, &id)!=SCIP_OKAY) return 1;
+      cout << "COLUMN " << id << "\n";
+    }
+    else if (cmd=="remove") {
+      vector<int> ids; int id;
+      while (in >> id) ids.push_back(id);
+      if (session.remove_columns(ids)!=SCIP_OKAY) return 1;
+    }
+    else if (cmd=="solve") {
+      if (session.solve()!=SCIP_OKAY) return 1;
+      if (!session.optimal()) { cout << "INFEASIBLE\n"; }
+      else {
+        // a duals file is rewritten before the line, which tells the reader it is complete
+        if (dualOut.mode==DualOutput::Mmap && emit_duals(session, dualOut)!=SCIP_OKAY) return 1;
+        cout << "OBJ " << session.objective() << " ITER " << session.iterations() << "\n";
+        if (dualOut.mode!=DualOutput::Mmap && emit_duals(session, dualOut)!=SCIP_OKAY) return 1;
+      }
+    }
+    else if (cmd=="cg") {
+      ColumnGenerationResult result;
+      if (run_column_generation(session, cgOptions, pool, result)!=SCIP_OKAY) return 1;
+      if (!session.optimal()) { cout << "INFEASIBLE\n"; }
+      else {
+        if (dualOut.mode==DualOutput::Mmap && emit_duals(session, dualOut)!=SCIP_OKAY) return 1;
+        cout << "CG OBJ " << result.objective << " ROUNDS " << result.rounds << " COLUMNS " << result.columns
+             << " ITER " << result.lpIterations << "\n";
+        if (dualOut.mode!=DualOutput::Mmap && emit_duals(session, dualOut)!=SCIP_OKAY) return 1;
+      }
+    }
+    else if (cmd=="supply") {
+      string loc, prod; int value = 0;
+      if (!(in >> loc >> prod >> value)) { cerr << "supply needs <locId> <prodId> <value>\n"; continue; }
+      const int l = idOf(li.locationKeys, loc, "location"), p = idOf(li.productKeys, prod, "product");
+      if (l>=0 && p>=0 && replanner.set_net_supply_demand(l, p, value)!=SCIP_OKAY)
+        cerr << "supply " << loc << " " << prod << ": not possible on the presolved instance, restart without --presolve\n";
+    }
+    else if (cmd=="route") {
+      string key, state; in >> key >> state;
+      const int r = idOf(li.routeKeys, key, "route"), on = onOff(cmd, state);
+      if (r>=0 && on>=0 && replanner.set_route_enabled(r, on)!=SCIP_OKAY) return 1;
+    }
+    else if (cmd=="tr") {
+      string key, state; in >> key >> state;
+      const int t = idOf(li.transportResourceKeys, key, "transport resource"), on = onOff(cmd, state);
+      const SCIP_RETCODE rc = t>=0 && on>=0 ? replanner.set_transport_resource_enabled(t, on) : SCIP_OKAY;
+      if (rc==SCIP_INVALIDDATA) cerr << "tr " << key << ": not possible on the presolved instance, restart without --presolve\n";
+      else if (rc!=SCIP_OKAY) return 1;
+    }
+    else if (cmd=="settings") {
+      double co2Costs = 0, capitalCosts = 0;
+      if (!(in >> co2Costs >> capitalCosts)) { cerr << "settings needs <co2Costs> <capitalCosts>\n"; continue; }
+      const SCIP_RETCODE rc = replanner.set_settings(Settings(co2Costs, capitalCosts));
+      if (rc==SCIP_INVALIDDATA) cerr << "settings: a new co2Costs is not possible on the presolved instance, restart without --presolve\n";
+      else if (rc!=SCIP_OKAY) return 1;
+    }
+    else { cerr << "unknown command " << cmd << "\n"; }
+    cout.flush();
+  }
+  return 0;
+}
+
+// Column generation mode: prices in-process until no packing improves, then reports like solve
+//   "CG OBJ <value> ROUNDS <n> COLUMNS <k> ITER <pivots> ..." + duals of the final RMP
+// With --pool the pattern file is read first (if it exists) and rewritten with everything found.
+// With --farkas the RMP has no Big-M y columns and is made feasible by Farkas pricing.
+// With --greedy the RMP is seeded with the packings of greedy_plan before the first solve; its
+// cost is logged as "greedy: cost <c> ..." on stderr when it routes every demand.
+// With --gap / --tailing the loop stops early once the RMP value is within the relative gap of the
+// best Lagrangian or Farley bound, or improved by less than the relative amount over the rounds.
+// With --snapshot the columns and the basis of a previous run are loaded first (if the file
+// exists), matched to this instance by name, and the file is rewritten after the run.
+// With --asp-pricing (repeatable; pricing_multishot.lp first, then side constraint programs) the
+// rounds are priced by clingo on a program grounded once, see asp_pricing.h. Needs LNO_WITH_CLINGO.
+// With --heuristic the LP is followed by a dive and a restricted integer master over all generated
+// columns; instead of the duals, "PLAN COST <c> UNCOVERED <units>" and the flow/4, transportLink/5
+// facts of the best plan are printed.
+static int run_heuristic(RmpSession& session, const ColumnGenerationOptions& options, WorkStealingPool& pool,
+                         ColumnPool* columnPool, const IntegerMasterOptions& mip, const TransportPlan* greedy){
+  TransportPlan divePlan, plan;
+  bool dived = false, solved = false;
+  if (dive(session, options, pool, columnPool, DivingOptions(), divePlan, dived)!=SCIP_OKAY) return 1;
+
+  // the cheaper of the dive's and the greedy plan is the MIP start
+  const TransportPlan* start = dived ? &divePlan : nullptr;
+  if (greedy && (!start || greedy->cost < start->cost)) start = greedy;
+
+  std::vector<Packing> columns;
+  for (const auto& entry: session.columns()) columns.push_back(entry.second);
+  if (solve_restricted_integer_master(session.instance(), columns, mip, start, plan, solved)!=SCIP_OKAY) return 1;
+  if (!solved && !start) { cout << "NOPLAN\n"; return 1; }
+  if (!solved) plan = *start;
+
+  cout << "PLAN COST " << plan.cost << " UNCOVERED " << plan.uncovered << "\n";
+  write_plan_facts(cout, session.instance(), plan);
+  return 0;
+}
+
+static int run_cg(const Instance& instance, const ColumnGenerationOptions& options, const char* poolPath,
+                  const DualOutput& dualOut, const IntegerMasterOptions* mip, bool greedy, const char* snapshotPath){
+  RmpSession session(instance);
+  {
+    ScopedTimer timer(options.stats, "build");
+    if (session.init(options.stabilization.boxStep, !options.farkas)!=SCIP_OKAY) return 1;
+  }
+  TransportPlan greedyPlan;
+  bool greedyComplete = false;
+  if (greedy) {
+    ScopedTimer timer(options.stats, "greedy");
+    greedyComplete = greedy_plan(instance, greedyPlan);
+    if (seed_columns(session, greedyPlan)!=SCIP_OKAY) return 1;
+    if (greedyComplete) cerr << "greedy: cost " << greedyPlan.cost << " columns " << greedyPlan.links.size() << "\n";
+    else cerr << "greedy: incomplete, " << greedyPlan.links.size() << " columns\n";
+  }
+  if (snapshotPath) {
+    ScopedTimer timer(options.stats, "snapshot_load");
+    SnapshotLoad load;
+    if (load_snapshot(session, snapshotPath, load)!=SCIP_OKAY) return 1;
+    if (load.found)
+      cerr << "snapshot: " << (load.exact ? "same instance" : "changed instance") << ", " << load.columns << " columns, "
+           << load.columnsSkipped << " skipped, " << load.statuses << " basis statuses, " << load.statusesSkipped
+           << " skipped\n";
+  }
+  WorkStealingPool pool(options.pricing.threads);
+  ColumnPool columnPool(instance);
+  if (poolPath) {
+    string error; size_t skipped = 0;
+    if (columnPool.load(poolPath, error, &skipped))
+      cerr << "pool: " << columnPool.size() << " patterns, " << skipped << " skipped\n";
+  }
+  if (poolPath)
+    for (const auto& link: greedyPlan.links) columnPool.insert(link.first);
+  ColumnGenerationResult result;
+  if (run_column_generation(session, options, pool, result, poolPath ? &columnPool : nullptr)!=SCIP_OKAY) {
+    if (!result.error.empty()) cerr << result.error << "\n";
+    return 1;
+  }
+
+  int rc = 1;
+  if (!session.optimal()) cout << "INFEASIBLE\n";
+  else {
+    cout << "CG OBJ " << result.objective << " ROUNDS " << result.rounds << " COLUMNS " << result.columns
+         << " ITER " << result.lpIterations << " POOL " << result.poolRounds << " PRICER " << result.pricerRounds
+         << " MISPRICE " << result.mispricings << " BOUND " << result.lowerBound << " GAP " << result.gap << "\n";
+    if (result.gapClosed || result.tailingOff)
+      cerr << "cg: stopped early, " << (result.gapClosed ? "gap closed" : "tailing off") << "\n";
+    // before the dive, which leaves its last basis behind
+    if (snapshotPath && save_snapshot(session, snapshotPath)!=SCIP_OKAY)
+      cerr << "Error writing snapshot " << snapshotPath << "\n";
+    if (mip) {
+      ScopedTimer timer(options.stats, "heuristic");
+      rc = run_heuristic(session, options, pool, poolPath ? &columnPool : nullptr, *mip,
+                         greedyComplete ? &greedyPlan : nullptr);
+    }
+    else rc = emit_duals(session, dualOut)==SCIP_OKAY ? 0 : 1;
+  }
+  if (poolPath && !columnPool.save(poolPath)) cerr << "Error writing column pool " << poolPath << "\n";
+  return rc;
+}
+
+// usage: lno_rmp_stdin [--session | --cg [--threads N] [--partial K] [--pool <file>]
+//                                       [--smooth <alpha>] [--box-step <width>] [--stab-log]
+//                                       [--heuristic [--mip-time <s>]] [--stats <file>] [--stats-stream]
+//                                       [--greedy] [--farkas] [--snapshot <file>]
+//                                       [--gap <rel>] [--tailing <rounds> <rel>]
+//                                       [--asp-pricing <file.lp>... [--asp-scale <s>] [--asp-arg <opt>...]]]
+//                      [--facts <file.lp>] [--presolve]
+//                      [--duals-binary | --duals-file <path>]   (session mode: --duals-file only)
+//        lno_rmp_stdin --sweep <scenarios> [--chains N] [--greedy] [cg options] [--facts <file.lp>]
+//          scenarios: "<co2Costs> <capitalCosts>" per line, see sweep.h
+//        lno_rmp_stdin --batch [--workers N] [--manifest] [--presolve] [--cg ...] [--duals-binary]
+//          stdin: one instance json per line (or one path per line with --manifest), see batch.h
+int main(int argc, char** argv){
   ios::sync_with_stdio(false);
   cin.tie(nullptr);
 
-  // read whole stdin into a string
-  std::ostringstream buf;
-  buf << cin.rdbuf();
-  json data = json::parse(buf.str());
+  bool session = false, cg = false, batch = false, presolve = false;
+  BatchOptions batchOptions;
+  ColumnGenerationOptions cgOptions;
+  PricingOptions& pricing = cgOptions.pricing;
+  StabilizationOptions& stab = cgOptions.stabilization;
+  const char* poolPath = nullptr;
+  const char* snapshotPath = nullptr;
+  const char* sweepPath = nullptr;
+  SweepOptions sweepOptions;
+  bool heuristic = false, greedy = false;
+  IntegerMasterOptions mip;
+  const char* factsPath = nullptr;
+  const char* statsPath = nullptr;
+  Stats stats;
+  DualOutput dualOut;
+#ifdef LNO_WITH_CLINGO
+  vector<string> aspFiles;
+  AspPricingOptions aspOptions;
+#endif
+  for (int i=1; i<argc; ++i) {
+    if (strcmp(argv[i], "--session")==0) session = true;
+    else if (strcmp(argv[i], "--cg")==0) cg = true;
+    else if (strcmp(argv[i], "--batch")==0) batch = true;
+    else if (strcmp(argv[i], "--workers")==0 && i+1<argc) batchOptions.workers = (size_t)atoi(argv[++i]);
+    else if (strcmp(argv[i], "--sweep")==0 && i+1<argc) sweepPath = argv[++i];
+    else if (strcmp(argv[i], "--chains")==0 && i+1<argc) sweepOptions.chains = (size_t)atoi(argv[++i]);
+    else if (strcmp(argv[i], "--manifest")==0) batchOptions.manifest = true;
+    else if (strcmp(argv[i], "--threads")==0 && i+1<argc) pricing.threads = (size_t)atoi(argv[++i]);
+    else if (strcmp(argv[i], "--partial")==0 && i+1<argc) pricing.maxColumns = (size_t)atoi(argv[++i]);
+    else if (strcmp(argv[i], "--pool")==0 && i+1<argc) poolPath = argv[++i];
+    else if (strcmp(argv[i], "--snapshot")==0 && i+1<argc) snapshotPath = argv[++i];
+    else if (strcmp(argv[i], "--smooth")==0 && i+1<argc) { stab.smoothing = true; stab.alpha = atof(argv[++i]); }
+    else if (strcmp(argv[i], "--box-step")==0 && i+1<argc) { stab.boxStep = true; stab.boxWidth = atof(argv[++i]); }
+    else if (strcmp(argv[i], "--stab-log")==0) stab.log = &cerr;
+    else if (strcmp(argv[i], "--heuristic")==0) heuristic = true;
+    else if (strcmp(argv[i], "--greedy")==0) greedy = true;
+    else if (strcmp(argv[i], "--farkas")==0) cgOptions.farkas = true;
+    else if (strcmp(argv[i], "--gap")==0 && i+1<argc) cgOptions.convergence.gap = atof(argv[++i]);
+    else if (strcmp(argv[i], "--tailing")==0 && i+2<argc) {
+      cgOptions.convergence.tailingRounds = (size_t)atoi(argv[++i]);
+      cgOptions.convergence.tailingImprovement = atof(argv[++i]);
+    }
+    else if (strcmp(argv[i], "--mip-time")==0 && i+1<argc) mip.timeLimit = atof(argv[++i]);
+    else if (strcmp(argv[i], "--stats")==0 && i+1<argc) { statsPath = argv[++i]; cgOptions.stats = &stats; }
+    else if (strcmp(argv[i], "--stats-stream")==0) { stats.stream_rounds(&cerr); cgOptions.stats = &stats; }
+    else if (strcmp(argv[i], "--facts")==0 && i+1<argc) factsPath = argv[++i];
+    else if (strcmp(argv[i], "--presolve")==0) presolve = true;
+    else if (strcmp(argv[i], "--duals-binary")==0) dualOut.mode = DualOutput::Binary;
+    else if (strcmp(argv[i], "--duals-file")==0 && i+1<argc) { dualOut.mode = DualOutput::Mmap; dualOut.path = argv[++i]; }
+#ifdef LNO_WITH_CLINGO
+    else if (strcmp(argv[i], "--asp-pricing")==0 && i+1<argc) aspFiles.push_back(argv[++i]);
+    else if (strcmp(argv[i], "--asp-scale")==0 && i+1<argc) aspOptions.scale = atof(argv[++i]);
+    else if (strcmp(argv[i], "--asp-arg")==0 && i+1<argc) aspOptions.arguments.push_back(argv[++i]);
+#else
+    else if (strncmp(argv[i], "--asp-", 6)==0) { cerr << argv[i] << ": built without clingo (LNO_WITH_CLINGO)\n"; return 1; }
+#endif
+    else { cerr << "unknown argument " << argv[i] << "\n"; return 1; }
+  }
+
+  if (cgOptions.stats && (session || batch || !(cg || sweepPath)))
+    cerr << "--stats/--stats-stream only apply to --cg and --sweep, ignored\n";
+  if (session) {
+    // the command replies are text lines, a binary block in between could not be told apart
+    if (dualOut.mode==DualOutput::Binary) { cerr << "--duals-binary is not supported in session mode, use --duals-file\n"; return 1; }
+    return run_session(dualOut, factsPath, presolve, cgOptions);
+  }
+  if (batch) {
+    if (dualOut.mode==DualOutput::Mmap) { cerr << "--duals-file is not supported in batch mode\n"; return 1; }
+    batchOptions.cg = cg;
+    batchOptions.presolve = presolve;
+    batchOptions.greedy = greedy;
+    batchOptions.binaryDuals = dualOut.mode==DualOutput::Binary;
+    batchOptions.options = cgOptions;
+    const size_t failed = run_batch(cin, cout, batchOptions);
+    if (failed) cerr << failed << " batch job(s) failed\n";
+    return failed ? 1 : 0;
+  }
 
-  Settings settings;
-  vector<Location*> locations;
-  vector<TransportResource*> trs;
-  vector<Product*> products;
-  vector<Route*> routes;
+  // parse stdin as it streams in, or map the fact file
+  Arena arena;
+  LoadedInstance li;
+  {
+    ScopedTimer timer(cgOptions.stats, "load");
+    if (factsPath ? !load_facts(factsPath, arena, li) : !load(cin, arena, li)) return 1;
+  }
 
-  build_from_json(data, settings, locations, trs, products, routes);
+  Instance instance;
+  {
+    ScopedTimer timer(cgOptions.stats, "build");
+    instance = build_instance(li.settings, li.locations, li.transportResources, li.products, li.routes);
+  }
+  if (presolve && sweepPath) cerr << "--presolve ignored in a sweep, its slot dominance depends on the cost rates\n";
+  else if (presolve) {
+    // stdout carries the duals, the reductions go to the log
+    ScopedTimer timer(cgOptions.stats, "presolve");
+    print_presolve_stats(cerr, presolve_instance(instance));
+  }
+  if (sweepPath) {
+    vector<Settings> scenarios;
+    string error;
+    ifstream in(sweepPath);
+    if (!in) { cerr << "Cannot open " << sweepPath << "\n"; return 1; }
+    if (!read_scenarios(in, scenarios, error)) { cerr << "Error reading scenarios: " << error << "\n"; return 1; }
+    sweepOptions.greedy = greedy;
+    sweepOptions.options = cgOptions;
+    vector<ScenarioResult> results;
+    {
+      ScopedTimer timer(cgOptions.stats, "sweep");
+      if (!run_sweep(instance, scenarios, sweepOptions, results)) { cerr << "sweep failed\n"; return 1; }
+    }
+    write_sweep_report(cout, instance, sweepOptions, results);
+    if (statsPath) { stats.count("peak_rss_bytes", peak_rss_bytes()); ofstream out(statsPath); stats.write_json(out); }
+    return 0;
+  }
+  if (cg) {
+#ifdef LNO_WITH_CLINGO
+    unique_ptr<AspPricer> aspPricer;
+    if (!aspFiles.empty()) {
+      ScopedTimer timer(cgOptions.stats, "asp_ground");
+      aspPricer = make_unique<AspPricer>(instance, aspOptions);
+      string error;
+      if (!aspPricer->init(aspFiles, error)) { cerr << "Error grounding the pricing program: " << error << "\n"; return 1; }
+      cgOptions.pricer = aspPricer.get();
+    }
+#endif
+    int rc = run_cg(instance, cgOptions, poolPath, dualOut, heuristic ? &mip : nullptr, greedy, snapshotPath);
+#ifdef LNO_WITH_CLINGO
+    if (aspPricer)
+      cerr << "asp: " << aspPricer->solves() << " solves, " << aspPricer->assignments() << " externals assigned\n";
+#endif
+    if (statsPath) { stats.count("peak_rss_bytes", peak_rss_bytes()); ofstream out(statsPath); stats.write_json(out); }
+    return rc;
+  }
+  if (dualOut.mode==DualOutput::Text) {
+    auto rc = solve_rmp_from_data(instance);
+    return rc==SCIP_OKAY ? 0 : 1;
+  }
 
-  auto rc = solve_rmp_from_data(settings, locations, trs, products, routes);
-  return rc==SCIP_OKAY ? 0 : 1;
+  RmpSession rmp(instance);
+  if (rmp.init()!=SCIP_OKAY || rmp.solve()!=SCIP_OKAY || !rmp.optimal()) return 1;
+  return emit_duals(rmp, dualOut)==SCIP_OKAY ? 0 : 1;
 }
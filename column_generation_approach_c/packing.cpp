@@ -0,0 +1,143 @@
+//
+// Packings: trip costs and the bounded knapsack behind the pricers.
+//
+
+#include "packing.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+using namespace std;
+
+/** profits below this are treated as zero when deciding whether to pack an item */
+static const double PROFIT_EPS = 1e-9;
+
+double packing_cost(const Instance &instance, int transportResource, double distance,
+                    const vector<tuple<int, int>> &items) {
+  const Settings &settings = instance.settings;
+  double cost = distance * (instance.trCost[transportResource] +
+                            settings.co2Costs * instance.trCo2Emissions[transportResource]);
+
+  const double speed = instance.trSpeed[transportResource];
+  if (speed > 0) {
+    double value = 0;
+    for (const auto &item : items)
+      value += instance.productValue[get<0>(item)] * get<1>(item);
+    cost += settings.capitalCosts * value * distance / speed;
+  }
+
+  return cost;
+}
+
+double solve_bounded_knapsack(const vector<double> &profit, const vector<int> &size,
+                              const vector<int> &bound, int capacity, vector<int> &x) {
+  const size_t n = profit.size();
+  x.assign(n, 0);
+
+  if (capacity <= 0)
+    return 0;
+
+  // scale the capacity down by the common divisor of all sizes to keep the table small
+  int divisor = 0;
+  for (size_t i = 0; i < n; ++i)
+    if (profit[i] > PROFIT_EPS && size[i] > 0 && bound[i] > 0)
+      divisor = gcd(divisor, size[i]);
+  if (divisor == 0)
+    return 0;
+  const int cap = capacity / divisor;
+
+  // split every bounded item into 0/1 items of 1, 2, 4, ... units
+  struct Chunk {
+    size_t item;
+    int units;
+    int weight;
+    double profit;
+  };
+  vector<Chunk> chunks;
+  for (size_t i = 0; i < n; ++i) {
+    if (profit[i] <= PROFIT_EPS || size[i] <= 0 || bound[i] <= 0)
+      continue;
+    int weight = size[i] / divisor;
+    int remaining = min(bound[i], cap / weight);
+    for (int units = 1; remaining > 0; units *= 2) {
+      int take = min(units, remaining);
+      chunks.push_back({i, take, take * weight, take * profit[i]});
+      remaining -= take;
+    }
+  }
+
+  vector<double> best(cap + 1, 0.0);
+  vector<char> taken(chunks.size() * (cap + 1), 0);
+  for (size_t k = 0; k < chunks.size(); ++k) {
+    const Chunk &chunk = chunks[k];
+    for (int c = cap; c >= chunk.weight; --c) {
+      double candidate = best[c - chunk.weight] + chunk.profit;
+      if (candidate > best[c] + PROFIT_EPS) {
+        best[c] = candidate;
+        taken[k * (cap + 1) + c] = 1;
+      }
+    }
+  }
+
+  // reconstruct the packing
+  int c = cap;
+  for (size_t k = chunks.size(); k-- > 0;) {
+    if (taken[k * (cap + 1) + c]) {
+      x[chunks[k].item] += chunks[k].units;
+      c -= chunks[k].weight;
+    }
+  }
+
+  return best[cap];
+}
+
+double price_packing(const Instance &instance, size_t route, size_t slot, const vector<double> &duals,
+                     bool farkas, Packing &packing) {
+  const size_t n = instance.P;
+  const int tr = instance.routeTR[slot];
+  const double distance = instance.routeDistance[slot];
+  const int capacity = (int)floor(instance.trCapacity[tr] + PROFIT_EPS);
+
+  vector<double> profit(n, 0.0);
+  vector<int> size(n, 0);
+  vector<int> bound(n, 0);
+
+  const double transit = instance.trSpeed[tr] > 0 ? distance / instance.trSpeed[tr] : 0;
+
+  for (size_t p = 0; p < n; ++p) {
+    if (!instance.valid(p, tr) || !instance.active(route, p))
+      continue;
+
+    // the knapsack works on integer sizes, rounding up keeps every packing feasible
+    size[p] = (int)ceil(instance.productSize[p] - PROFIT_EPS);
+    if (size[p] <= 0)
+      continue;
+    bound[p] = capacity / size[p];
+
+    profit[p] = duals[p];
+    if (!farkas)
+      profit[p] -= instance.settings.capitalCosts * instance.productValue[p] * transit;
+  }
+
+  vector<int> x;
+  solve_bounded_knapsack(profit, size, bound, capacity, x);
+
+  packing.route = (int)route;
+  packing.transportResource = tr;
+  packing.distance = distance;
+  packing.items.clear();
+  double covered = 0;
+  for (size_t p = 0; p < n; ++p) {
+    if (x[p] > 0) {
+      packing.items.emplace_back((int)p, x[p]);
+      covered += x[p] * duals[p];
+    }
+  }
+  packing.cost = packing_cost(instance, tr, distance, packing.items);
+
+  if (packing.items.empty())
+    return 0;
+
+  return (farkas ? 0 : packing.cost) - covered;
+}
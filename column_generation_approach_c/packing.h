@@ -0,0 +1,53 @@
+//
+// Packings: what one trip carries, its cost and the bounded knapsack that finds the best one.
+// No solver needed; the SCIP pricer is in pricer_knapsack.h.
+//
+
+#ifndef LNO_PACKING_H
+#define LNO_PACKING_H
+
+#include <cstddef>
+#include <tuple>
+#include <vector>
+
+#include "instance.h"
+
+using namespace std;
+
+/** a packing: how many units of each product one trip of a transport resource carries over a route */
+struct Packing {
+  int route;
+  int transportResource;
+  double distance;
+  vector<tuple<int, int>> items; // (product, units)
+  double cost;
+};
+
+struct PricingOptions {
+  size_t threads = 1;       // pricing threads including the caller, 0 = one per hardware thread
+  size_t maxColumns = 0;    // partial pricing: stop once this many improving columns are found, 0 = all
+  double tolerance = 1e-6;  // a column improves if its reduced cost is below -tolerance
+};
+
+/** cost of a single trip: distance based transport and CO2 costs plus capital bound in the goods while in transit */
+double packing_cost(const Instance &instance, int transportResource, double distance,
+                    const vector<tuple<int, int>> &items);
+
+/** solves max sum profit[i] * x[i] s.t. sum size[i] * x[i] <= capacity, 0 <= x[i] <= bound[i] integer
+ *
+ *  Items with non-positive profit or size are never packed. Returns the optimal profit and writes the
+ *  item multiplicities to x.
+ */
+double solve_bounded_knapsack(const vector<double> &profit, const vector<int> &size,
+                              const vector<int> &bound, int capacity, vector<int> &x);
+
+/** best packing for one route / transport resource pair given the duals of its demand constraints
+ *
+ *  slot indexes the instance's routeTR array, duals[p] belongs to product p. With farkas set, the
+ *  trip costs are ignored (Farkas pricing). Returns the reduced cost of the packing, which is only
+ *  meaningful if it is negative.
+ */
+double price_packing(const Instance &instance, size_t route, size_t slot, const vector<double> &duals,
+                     bool farkas, Packing &packing);
+
+#endif // LNO_PACKING_H
@@ -0,0 +1,229 @@
+//
+// Instance presolve: removes model parts that can never carry a unit.
+//
+
+#include "presolve.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+/** same tolerance and rounding as price_packing */
+static const double SIZE_EPS = 1e-9;
+
+namespace {
+
+/** what one trip of a route slot costs and carries */
+struct Slot {
+  size_t index;          // position in routeTR
+  double tripCost;       // packing cost without the capital costs of the load
+  double transit;        // distance / speed, scales the capital costs of the load
+  int capacity;
+  vector<char> carries;  // [product]
+};
+
+/** a dominates b: carries a superset, costs no more, holds no less and travels no longer;
+ *  exact ties are broken by the position so only one of two identical slots survives */
+bool dominates(const Slot &a, const Slot &b) {
+  if (a.tripCost > b.tripCost || a.transit > b.transit || a.capacity < b.capacity)
+    return false;
+  for (size_t p = 0; p < a.carries.size(); ++p)
+    if (b.carries[p] && !a.carries[p])
+      return false;
+  if (a.tripCost < b.tripCost || a.transit < b.transit || a.capacity > b.capacity || a.carries != b.carries)
+    return true;
+  return a.index < b.index;
+}
+
+/** drops the slots that carry no active pair or are dominated on their route, compacting
+ *  routeTR in place; carried[rp] tells whether a remaining slot may carry the pair */
+void prune_slots(Instance &instance, PresolveStats &stats, vector<char> &carried) {
+  const size_t P = instance.P, R = instance.R;
+  const Settings &settings = instance.settings;
+
+  vector<int> productSize(P);
+  for (size_t p = 0; p < P; ++p)
+    productSize[p] = (int)ceil(instance.productSize[p] - SIZE_EPS);
+
+  fill(carried.begin(), carried.end(), 0);
+  vector<size_t> start(1, 0);
+  vector<int> routeTR;
+  vector<double> routeDistance;
+  vector<Slot> slots;
+  for (size_t r = 0; r < R; ++r) {
+    slots.clear();
+    for (size_t k = instance.routeTRStart[r]; k < instance.routeTRStart[r + 1]; ++k) {
+      const int tr = instance.routeTR[k];
+      const double distance = instance.routeDistance[k];
+      Slot slot;
+      slot.index = k;
+      slot.tripCost = distance * (instance.trCost[tr] + settings.co2Costs * instance.trCo2Emissions[tr]);
+      slot.transit = instance.trSpeed[tr] > 0 ? distance / instance.trSpeed[tr] : 0;
+      slot.capacity = (int)floor(instance.trCapacity[tr] + SIZE_EPS);
+      slot.carries.assign(P, 0);
+      bool any = false;
+      for (size_t p = 0; p < P; ++p)
+        if (instance.active(r, p) && instance.valid(p, tr) && productSize[p] > 0 &&
+            productSize[p] <= slot.capacity) {
+          slot.carries[p] = 1;
+          any = true;
+        }
+      if (any)
+        slots.push_back(std::move(slot));
+      else
+        ++stats.slotsUnusable;
+    }
+
+    for (size_t i = 0; i < slots.size(); ++i) {
+      bool dominated = false;
+      for (size_t j = 0; j < slots.size() && !dominated; ++j)
+        dominated = j != i && dominates(slots[j], slots[i]);
+      if (dominated) {
+        ++stats.slotsDominated;
+        continue;
+      }
+      routeTR.push_back(instance.routeTR[slots[i].index]);
+      routeDistance.push_back(instance.routeDistance[slots[i].index]);
+      for (size_t p = 0; p < P; ++p)
+        carried[instance.rp(r, p)] |= slots[i].carries[p];
+    }
+    start.push_back(routeTR.size());
+  }
+  instance.routeTRStart.swap(start);
+  instance.routeTR.swap(routeTR);
+  instance.routeDistance.swap(routeDistance);
+}
+
+} // namespace
+
+PresolveStats presolve_instance(Instance &instance) {
+  const size_t L = instance.L, P = instance.P, R = instance.R;
+  PresolveStats stats;
+
+  stats.slotsBefore = instance.routeTR.size();
+  for (size_t r = 0; r < R; ++r) {
+    bool used = false;
+    for (size_t p = 0; p < P; ++p)
+      if (instance.active(r, p)) {
+        ++stats.pairsBefore;
+        used = true;
+      }
+    stats.routesBefore += used;
+  }
+  vector<char> locationUsed(L, 0);
+  for (size_t l = 0; l < L; ++l)
+    for (size_t p = 0; p < P; ++p)
+      if (instance.flow_active(l, p)) {
+        ++stats.flowRowsBefore;
+        locationUsed[l] = 1;
+      }
+  for (char used : locationUsed)
+    stats.locationsBefore += used;
+
+  // 1. unusable and dominated slots
+  vector<char> carried(R * P, 0); // some remaining slot of the route may carry the product
+  prune_slots(instance, stats, carried);
+
+  // 2. per product, keep the carrying routes reachable from a supply and reaching a demand
+  const LocationIncidence &inc = instance.incidence;
+  vector<char> fromSupply(L), toDemand(L);
+  vector<size_t> queue;
+  queue.reserve(L);
+  for (size_t p = 0; p < P; ++p) {
+    fill(fromSupply.begin(), fromSupply.end(), 0);
+    fill(toDemand.begin(), toDemand.end(), 0);
+
+    queue.clear();
+    for (size_t l = 0; l < L; ++l)
+      if (instance.netSupplyDemand[instance.lp(l, p)] > 0) {
+        fromSupply[l] = 1;
+        queue.push_back(l);
+      }
+    for (size_t q = 0; q < queue.size(); ++q)
+      for (size_t k = inc.outStart[queue[q]]; k < inc.outStart[queue[q] + 1]; ++k) {
+        const size_t r = inc.outRoutes[k];
+        const int to = instance.routeTo[r];
+        if (carried[instance.rp(r, p)] && !fromSupply[to]) {
+          fromSupply[to] = 1;
+          queue.push_back(to);
+        }
+      }
+
+    queue.clear();
+    for (size_t l = 0; l < L; ++l)
+      if (instance.netSupplyDemand[instance.lp(l, p)] < 0) {
+        toDemand[l] = 1;
+        queue.push_back(l);
+      }
+    for (size_t q = 0; q < queue.size(); ++q)
+      for (size_t k = inc.inStart[queue[q]]; k < inc.inStart[queue[q] + 1]; ++k) {
+        const size_t r = inc.inRoutes[k];
+        const int from = instance.routeFrom[r];
+        if (carried[instance.rp(r, p)] && !toDemand[from]) {
+          toDemand[from] = 1;
+          queue.push_back(from);
+        }
+      }
+
+    for (size_t r = 0; r < R; ++r) {
+      const size_t i = instance.rp(r, p);
+      if (!instance.pairActive[i])
+        continue;
+      if (!carried[i]) {
+        ++stats.pairsWithoutTR;
+        instance.pairActive[i] = 0;
+      } else if (!fromSupply[instance.routeFrom[r]] || !toDemand[instance.routeTo[r]]) {
+        ++stats.pairsUnreachable;
+        instance.pairActive[i] = 0;
+      }
+    }
+  }
+
+  // slots that only carried pruned pairs
+  prune_slots(instance, stats, carried);
+  stats.slotsAfter = instance.routeTR.size();
+
+  // 3. flow rows without supply, demand or any remaining pair are empty
+  vector<char> touched(L * P, 0);
+  for (size_t r = 0; r < R; ++r) {
+    bool used = false;
+    for (size_t p = 0; p < P; ++p)
+      if (instance.active(r, p)) {
+        ++stats.pairsAfter;
+        touched[instance.lp(instance.routeFrom[r], p)] = 1;
+        touched[instance.lp(instance.routeTo[r], p)] = 1;
+        used = true;
+      }
+    stats.routesAfter += used;
+  }
+  fill(locationUsed.begin(), locationUsed.end(), 0);
+  for (size_t l = 0; l < L; ++l)
+    for (size_t p = 0; p < P; ++p) {
+      const size_t i = instance.lp(l, p);
+      instance.flowActive[i] = instance.flowActive[i] && (touched[i] || instance.netSupplyDemand[i] != 0);
+      if (instance.flowActive[i]) {
+        ++stats.flowRowsAfter;
+        locationUsed[l] = 1;
+      }
+    }
+  for (char used : locationUsed)
+    stats.locationsAfter += used;
+
+  instance.presolved = true;
+  return stats;
+}
+
+void print_presolve_stats(ostream &os, const PresolveStats &stats) {
+  os << "Presolve: transport resources on routes " << stats.slotsBefore << " -> " << stats.slotsAfter
+     << " (" << stats.slotsUnusable << " unusable, " << stats.slotsDominated << " dominated)\n"
+     << "Presolve: route/product pairs " << stats.pairsBefore << " -> " << stats.pairsAfter << " ("
+     << stats.pairsWithoutTR << " without transport resource, " << stats.pairsUnreachable
+     << " off every supply-demand path)\n"
+     << "Presolve: routes " << stats.routesBefore << " -> " << stats.routesAfter << ", locations "
+     << stats.locationsBefore << " -> " << stats.locationsAfter << ", flow rows " << stats.flowRowsBefore
+     << " -> " << stats.flowRowsAfter << "\n"
+     << "Presolve: LP " << 2 * stats.pairsBefore << " -> " << 2 * stats.pairsAfter << " columns, "
+     << stats.flowRowsBefore + stats.pairsBefore << " -> " << stats.flowRowsAfter + stats.pairsAfter
+     << " rows" << endl;
+}
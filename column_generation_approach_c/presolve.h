@@ -0,0 +1,55 @@
+//
+// Instance presolve: removes model parts that can never carry a unit.
+//
+
+#ifndef LNO_PRESOLVE_H
+#define LNO_PRESOLVE_H
+
+#include <ostream>
+
+#include "instance.h"
+
+using namespace std;
+
+/** sizes before and after presolve */
+struct PresolveStats {
+  /* (route, transport resource) slots */
+  size_t slotsBefore = 0;
+  size_t slotsAfter = 0;
+  size_t slotsUnusable = 0;  // no product fits or may use the transport resource
+  size_t slotsDominated = 0;
+
+  /* (route, product) pairs, each one f and one y variable and one cover row */
+  size_t pairsBefore = 0;
+  size_t pairsAfter = 0;
+  size_t pairsWithoutTR = 0;   // no remaining transport resource on the route may carry the product
+  size_t pairsUnreachable = 0; // route not on any supply-to-demand path of the product
+
+  /* routes and locations with at least one remaining pair or flow row */
+  size_t routesBefore = 0;
+  size_t routesAfter = 0;
+  size_t flowRowsBefore = 0;
+  size_t flowRowsAfter = 0;
+  size_t locationsBefore = 0;
+  size_t locationsAfter = 0;
+};
+
+/** reduces the instance in place, ids stay unchanged
+ *
+ *  1. drops the transport resources of a route no product can be packed into (same integer
+ *     rounding as the knapsack pricer), and the ones dominated on that route: another one of the
+ *     route carries every product it carries, is not more expensive per trip, not smaller and
+ *     not slower, so every packing can move to it at no higher cost
+ *  2. switches off the (route, product) pairs without a remaining transport resource and the
+ *     ones whose route does not lie on a supply-to-demand path of the product
+ *  3. switches off the flow rows of (location, product) without supply, demand or pair left
+ *
+ *  Flow that only Big-M slack could have covered is removed with the pairs, so an instance
+ *  that was only feasible through the slack becomes infeasible.
+ */
+PresolveStats presolve_instance(Instance &instance);
+
+/** one line per reduction, for the log */
+void print_presolve_stats(ostream &os, const PresolveStats &stats);
+
+#endif // LNO_PRESOLVE_H
@@ -0,0 +1,216 @@
+//
+// Knapsack pricer for the logistics network optimization problem.
+//
+
+#include "pricer_knapsack.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "objscip/objscip.h"
+
+#include "column_pool.h"
+#include "convergence.h"
+#include "pricing.h"
+#include "stats.h"
+#include "thread_pool.h"
+
+using namespace std;
+using namespace scip;
+
+/** constructs the pricer object with the data needed */
+PricerKnapsack::PricerKnapsack(SCIP *scip, const char *name, const Instance &instance,
+                               const vector<SCIP_CONS *> &demand_con, const PricingOptions &options)
+    : ObjPricer(scip, name, "Finds packing with negative reduced cost.", 0, TRUE),
+      _instance(instance), _demand_con(demand_con), _options(options),
+      _pool(new WorkStealingPool(options.threads)), _defaultNames(instance, false), _names(&_defaultNames),
+      _duals(demand_con.size()) {}
+
+/** destructs the pricer object */
+PricerKnapsack::~PricerKnapsack() = default;
+
+/** initialization method of variable pricer (called after problem was transformed)
+ *
+ *  The pricer works on the transformed problem, so the demand constraints are replaced
+ *  by their transformed counterparts.
+ */
+SCIP_DECL_PRICERINIT(PricerKnapsack::scip_init) {
+  for (auto &con : _demand_con) {
+    if (con != nullptr)
+      SCIP_CALL(SCIPgetTransformedCons(scip, con, &con));
+  }
+
+  return SCIP_OKAY;
+}
+
+/** reduced cost pricing method of variable pricer for feasible LPs
+ *
+ *  Reports Farley's bound as the node's lower bound. Stopping early is reported as
+ *  SCIP_DIDNOTRUN, so SCIP does not take the LP value as the node's bound.
+ */
+SCIP_DECL_PRICERREDCOST(PricerKnapsack::scip_redcost) {
+  SCIPdebugMsg(scip, "call scip_redcost ...\n");
+
+  /* call pricing routine */
+  bool stop = false;
+  SCIP_CALL(pricing(scip, false, lowerbound, &stop));
+
+  /* set result pointer, see above */
+  *result = stop ? SCIP_DIDNOTRUN : SCIP_SUCCESS;
+
+  return SCIP_OKAY;
+}
+
+/** farkas pricing method of variable pricer for infeasible LPs */
+SCIP_DECL_PRICERFARKAS(PricerKnapsack::scip_farkas) {
+  SCIPdebugMsg(scip, "call scip_farkas ...\n");
+
+  /* set result pointer, see above */
+  *result = SCIP_SUCCESS;
+
+  /* call pricing routine */
+  SCIP_CALL(pricing(scip, true));
+
+  return SCIP_OKAY;
+}
+
+/** ends pricing at a node early */
+void PricerKnapsack::set_convergence(const ConvergenceOptions &options) {
+  _convergence.reset(new ConvergenceMonitor(options));
+}
+
+/** performs pricing */
+SCIP_RETCODE PricerKnapsack::pricing(SCIP *scip, bool farkas, SCIP_Real *lowerbound, bool *stop) {
+  ScopedTimer timer(_stats, farkas ? "pricing_farkas" : "pricing");
+  const double start = _stats != nullptr ? _stats->wall() : 0.0;
+
+  /* SCIP is not thread safe, so the duals are read up front */
+  for (size_t i = 0; i < _demand_con.size(); ++i) {
+    SCIP_CONS *con = _demand_con[i];
+    if (con == nullptr)
+      _duals[i] = 0.0;
+    else
+      _duals[i] = farkas ? SCIPgetDualfarkasLinear(scip, con) : SCIPgetDualsolLinear(scip, con);
+  }
+
+  PricingOptions options = _options;
+  options.tolerance = SCIPdualfeastol(scip);
+
+  vector<Packing> columns;
+  vector<double> redcosts;
+  if (_columnPool != nullptr)
+    _columnPool->price(_duals.data(), farkas, options, *_pool, columns, redcosts);
+
+  bool complete = false;
+  if (columns.empty()) {
+    price_routes(_instance, _duals.data(), farkas, options, *_pool, columns, redcosts);
+    if (_columnPool != nullptr)
+      for (const auto &packing : columns)
+        _columnPool->insert(packing);
+    complete = options.maxColumns == 0;
+  }
+
+  /* Farley's bound needs the best packing of every route, the monitor restarts at each node */
+  double bound = -numeric_limits<double>::infinity();
+  if (!farkas && complete)
+    bound = farley_bound(_instance, best_per_route(_instance, columns, redcosts), SCIPgetLPObjval(scip));
+  if (!farkas && _convergence != nullptr) {
+    const SCIP_Longint node = SCIPnodeGetNumber(SCIPgetCurrentNode(scip));
+    if (node != _node) {
+      _convergence->reset();
+      _node = node;
+    }
+    _convergence->record(SCIPgetLPObjval(scip), bound);
+    bound = _convergence->lower_bound();
+    if (stop != nullptr && !columns.empty() && _convergence->stop()) {
+      *stop = true;
+      columns.clear();
+      if (_stats != nullptr)
+        _stats->count(_convergence->gap_closed() ? "gap_closed" : "tailing_off");
+    }
+  }
+  if (lowerbound != nullptr && bound > -numeric_limits<double>::infinity())
+    *lowerbound = max(*lowerbound, bound);
+
+  for (const auto &packing : columns) {
+    SCIP_CALL(add_packing_variable(scip, packing));
+  }
+
+  if (_stats != nullptr) {
+    const long lpIterations = (long)SCIPgetNLPIterations(scip);
+    Stats::Round round;
+    round.round = _stats->rounds().size() + 1;
+    round.wall = _stats->wall();
+    round.cpu = _stats->cpu();
+    round.primalBound = farkas ? numeric_limits<double>::infinity() : SCIPgetLPObjval(scip);
+    round.dualBound = max(SCIPgetDualbound(scip), bound);
+    round.lpIterations = lpIterations - _lpIterations;
+    round.columnsAdded = columns.size();
+    round.columnsTotal = _columns.size();
+    round.pricingSeconds = round.wall - start;
+    _stats->round(round);
+    _stats->count("columns_added", (long)columns.size());
+    _lpIterations = lpIterations;
+  }
+
+  return SCIP_OKAY;
+}
+
+/** adds the packing as new variable to the problem */
+SCIP_RETCODE PricerKnapsack::add_packing_variable(SCIP *scip, const Packing &packing) {
+  SCIP_VAR *var;
+  SCIP_CALL(create_packing_variable(scip, packing, false, &var));
+  SCIP_CALL(SCIPreleaseVar(scip, &var));
+
+  return SCIP_OKAY;
+}
+
+/** adds packings as ordinary variables before solving */
+SCIP_RETCODE PricerKnapsack::add_initial_columns(SCIP *scip, const vector<Packing> &packings,
+                                                 vector<SCIP_VAR *> &vars) {
+  for (const auto &packing : packings) {
+    SCIP_VAR *var;
+    SCIP_CALL(create_packing_variable(scip, packing, true, &var));
+    vars.push_back(var);
+  }
+
+  return SCIP_OKAY;
+}
+
+/** creates the variable of a packing with its cover coefficients, priced or initial */
+SCIP_RETCODE PricerKnapsack::create_packing_variable(SCIP *scip, const Packing &packing, bool initial,
+                                                     SCIP_VAR **var) {
+  const Entity entity{EntityKind::Packing, (uint32_t)packing.route, (uint32_t)packing.transportResource,
+                      (uint32_t)SCIPgetNVars(scip)};
+  const char *var_name = _names->name(entity);
+
+  SCIPdebugMsg(scip, "new variable <%s>\n", var_name);
+
+  /* create the new variable: the number of trips using this packing */
+  SCIP_CALL(SCIPcreateVar(scip, var, var_name,
+                          0.0,                     // lower bound
+                          SCIPinfinity(scip),      // upper bound
+                          packing.cost,            // objective
+                          SCIP_VARTYPE_CONTINUOUS, // variable type
+                          false, false, nullptr, nullptr, nullptr, nullptr, nullptr));
+  _names->record(*var, entity);
+
+  if (initial) {
+    SCIP_CALL(SCIPaddVar(scip, *var));
+  } else {
+    /* add new variable to the list of variables to price into LP (score: leave 1 here) */
+    SCIP_CALL(SCIPaddPricedVar(scip, *var, 1.0));
+  }
+
+  /* every trip covers the packed units of each product on the route */
+  for (const auto &item : packing.items) {
+    SCIP_CONS *con = _demand_con[_instance.rp(packing.route, get<0>(item))];
+    if (con == nullptr)
+      continue;
+    SCIP_CALL(SCIPaddCoefLinear(scip, con, *var, (double)get<1>(item)));
+  }
+
+  _columns.push_back(packing);
+
+  return SCIP_OKAY;
+}
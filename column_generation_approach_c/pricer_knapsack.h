@@ -0,0 +1,106 @@
+//
+// Knapsack pricer for the logistics network optimization problem.
+//
+
+#ifndef LNO_PRICER_KNAPSACK_H
+#define LNO_PRICER_KNAPSACK_H
+
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include "objscip/objscip.h"
+
+#include "instance.h"
+#include "lean.h"
+#include "packing.h"
+
+using namespace std;
+
+class ColumnPool;
+class ConvergenceMonitor;
+struct ConvergenceOptions;
+class Stats;
+class WorkStealingPool;
+
+/** pricer that solves one bounded knapsack per route and transport resource on the duals of the
+ *  demand constraints and adds every packing with negative reduced cost as a new column
+ *
+ *  The knapsacks are solved in parallel (see price_routes), SCIP is only called from the
+ *  pricing thread to read the duals and to add the columns.
+ */
+class PricerKnapsack : public scip::ObjPricer {
+public:
+  /** constructs the pricer object with the data needed
+   *
+   *  demand_con holds the demand constraint of (route, product) at instance.rp(route, product),
+   *  nullptr for the pairs presolve removed
+   */
+  PricerKnapsack(SCIP *scip, const char *name, const Instance &instance,
+                 const vector<SCIP_CONS *> &demand_con, const PricingOptions &options = PricingOptions());
+
+  /** destructs the pricer object */
+  ~PricerKnapsack() override;
+
+  /** initialization method of variable pricer (called after problem was transformed) */
+  SCIP_DECL_PRICERINIT(scip_init) override;
+
+  /** reduced cost pricing method of variable pricer for feasible LPs */
+  SCIP_DECL_PRICERREDCOST(scip_redcost) override;
+
+  /** farkas pricing method of variable pricer for infeasible LPs */
+  SCIP_DECL_PRICERFARKAS(scip_farkas) override;
+
+  /** performs pricing
+   *
+   *  A complete reduced cost round also gives Farley's bound on the node LP, returned in
+   *  lowerbound if given; stop is set if the convergence test says to end pricing at the node
+   *  instead, and no columns are added then.
+   */
+  SCIP_RETCODE pricing(SCIP *scip, bool farkas, SCIP_Real *lowerbound = nullptr, bool *stop = nullptr);
+
+  /** adds the packing as new variable to the problem */
+  SCIP_RETCODE add_packing_variable(SCIP *scip, const Packing &packing);
+
+  /** adds packings as ordinary variables before solving, e.g. a greedy start
+   *
+   *  vars receives the variables, still captured for setting a start solution; the caller
+   *  releases them.
+   */
+  SCIP_RETCODE add_initial_columns(SCIP *scip, const vector<Packing> &packings, vector<SCIP_VAR *> &vars);
+
+  /** prices the patterns of the pool before solving knapsacks and pools the packings found */
+  void set_column_pool(ColumnPool *columnPool) { _columnPool = columnPool; }
+
+  /** ends pricing at a node early once the gap to the Farley bound is closed or the LP value tails off */
+  void set_convergence(const ConvergenceOptions &options);
+
+  /** names the packing variables through the table, e.g. a lean one; full names by default */
+  void set_entity_names(EntityNames *names) { _names = names; }
+
+  /** records the time of every pricing call, the columns added and one round per call */
+  void set_stats(Stats *stats) { _stats = stats; }
+
+  /** every packing added as a variable so far, e.g. for a restricted integer master */
+  const vector<Packing> &columns() const { return _columns; }
+
+private:
+  /** creates the variable of a packing with its cover coefficients, priced or initial */
+  SCIP_RETCODE create_packing_variable(SCIP *scip, const Packing &packing, bool initial, SCIP_VAR **var);
+
+  const Instance &_instance;
+  vector<SCIP_CONS *> _demand_con;
+  PricingOptions _options;
+  unique_ptr<WorkStealingPool> _pool;
+  ColumnPool *_columnPool = nullptr;
+  vector<Packing> _columns;
+  Stats *_stats = nullptr;
+  EntityNames _defaultNames;
+  EntityNames *_names;
+  long _lpIterations = 0; // SCIP's LP iterations at the previous pricing call
+  unique_ptr<ConvergenceMonitor> _convergence;
+  SCIP_Longint _node = -1; // node the monitor's rounds belong to
+  vector<double> _duals; // rp-indexed duals of the demand constraints
+};
+
+#endif // LNO_PRICER_KNAPSACK_H
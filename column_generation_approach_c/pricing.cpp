@@ -0,0 +1,60 @@
+//
+// Parallel pricing of packing columns over all routes.
+//
+
+#include "pricing.h"
+
+#include <algorithm>
+#include <atomic>
+
+using namespace std;
+
+double price_routes(const Instance &instance, const double *coverDuals, bool farkas,
+                    const PricingOptions &options, WorkStealingPool &pool, vector<Packing> &columns,
+                    vector<double> &redcosts) {
+  // every task only writes the slots of its own route
+  vector<vector<Packing>> found(instance.R);
+  vector<vector<double>> foundRedcosts(instance.R);
+  vector<double> best(instance.R, 0.0);
+  atomic<size_t> nFound(0);
+
+  pool.parallel_for(instance.R, [&](size_t r) {
+    if (options.maxColumns > 0 && nFound.load(memory_order_relaxed) >= options.maxColumns)
+      return;
+
+    vector<double> duals(coverDuals + instance.rp(r, 0), coverDuals + instance.rp(r, 0) + instance.P);
+
+    for (size_t k = instance.routeTRStart[r]; k < instance.routeTRStart[r + 1]; ++k) {
+      if (!instance.enabled(r, instance.routeTR[k]))
+        continue;
+
+      Packing packing;
+      double redcost = price_packing(instance, r, k, duals, farkas, packing);
+      if (packing.items.empty())
+        continue;
+
+      best[r] = min(best[r], redcost);
+      if (redcost < -options.tolerance) {
+        found[r].push_back(std::move(packing));
+        foundRedcosts[r].push_back(redcost);
+        nFound.fetch_add(1, memory_order_relaxed);
+      }
+    }
+  });
+
+  size_t added = 0;
+  for (size_t r = 0; r < instance.R; ++r) {
+    for (size_t i = 0; i < found[r].size(); ++i) {
+      if (options.maxColumns > 0 && added == options.maxColumns)
+        break;
+      columns.push_back(std::move(found[r][i]));
+      redcosts.push_back(foundRedcosts[r][i]);
+      ++added;
+    }
+  }
+
+  double mostNegative = 0.0;
+  for (double b : best)
+    mostNegative = min(mostNegative, b);
+  return mostNegative;
+}
@@ -0,0 +1,45 @@
+//
+// Parallel pricing of packing columns over all routes.
+//
+
+#ifndef LNO_PRICING_H
+#define LNO_PRICING_H
+
+#include <string>
+#include <vector>
+
+#include "instance.h"
+#include "packing.h"
+#include "thread_pool.h"
+
+using namespace std;
+
+/** prices every route / transport resource pair as a task on the pool
+ *
+ *  coverDuals[instance.rp(r, p)] is the dual (or Farkas value) of the cover/demand constraint of
+ *  (r, p). Improving packings are appended to columns ordered by route and transport
+ *  resource, their reduced costs to redcosts. Returns the most negative reduced cost seen (0 if
+ *  none was negative); with partial pricing this is only a bound over the routes that were priced.
+ */
+double price_routes(const Instance &instance, const double *coverDuals, bool farkas,
+                    const PricingOptions &options, WorkStealingPool &pool, vector<Packing> &columns,
+                    vector<double> &redcosts);
+
+/** another way to price a round, used by column generation in place of price_routes
+ *
+ *  price has the contract of price_routes, the most negative reduced cost goes to mostNegative;
+ *  it returns false with a message in error if the round could not be priced. exact() tells
+ *  whether the most negative reduced cost per route is found, as needed for the Lagrangian and
+ *  Farley bounds.
+ */
+class RoutePricer {
+public:
+  virtual ~RoutePricer() = default;
+
+  virtual bool price(const double *coverDuals, bool farkas, const PricingOptions &options, vector<Packing> &columns,
+                     vector<double> &redcosts, double &mostNegative, string &error) = 0;
+
+  virtual bool exact() const = 0;
+};
+
+#endif // LNO_PRICING_H
@@ -0,0 +1,234 @@
+#include "primal_heuristic.h"
+#include "objscip/objscipdefplugins.h"
+#include "lean.h"
+#include <cmath>
+#include <map>
+#include <string>
+#include <string_view>
+using namespace scip;
+
+static const double BIG_M = 1e6;
+
+namespace {
+
+bool integral(double v, double tol) { return std::fabs(v - std::round(v)) <= tol; }
+
+// integral plan from the current session solution (packings and flows already integral)
+void plan_from_session(const RmpSession& session, TransportPlan& plan)
+{
+  const Instance& inst = session.instance();
+  plan = TransportPlan();
+  for (size_t r=0; r<inst.R; ++r) for (size_t p=0; p<inst.P; ++p) {
+    const int units = (int)std::lround(session.flow_value(r,p));
+    if (units > 0) plan.flows.emplace_back((int)r, (int)p, units);
+    plan.uncovered += std::lround(session.big_m_value(r,p));
+  }
+  for (const auto& [id, packing]: session.columns()) {
+    const int freq = (int)std::lround(session.column_value(id));
+    if (freq <= 0) continue;
+    plan.links.emplace_back(packing, freq);
+    plan.cost += freq*packing.cost;
+  }
+}
+
+// packing list term of the clingo encodings: p1, (p1,p2), (p1,(p2,p2)), ...
+std::string packing_list(const Instance& inst, const Packing& packing)
+{
+  std::vector<std::string_view> parts;
+  for (const auto& [p, units]: packing.items)
+    for (int u=0; u<units; ++u) parts.push_back(inst.products[p]->name);
+
+  std::string list(parts.empty() ? std::string_view() : parts.back());
+  for (size_t i=parts.size(); i-- > 1; )
+    list = "(" + std::string(parts[i-1]) + "," + list + ")";
+  return list;
+}
+
+using PackingKey = std::tuple<int, int, std::vector<std::tuple<int,int>>>;
+PackingKey key_of(const Packing& packing) { return {packing.route, packing.transportResource, packing.items}; }
+
+} // namespace
+
+SCIP_RETCODE dive(RmpSession& session, const ColumnGenerationOptions& options, WorkStealingPool& pool,
+                  ColumnPool* columnPool, const DivingOptions& diving, TransportPlan& plan, bool& found)
+{
+  const Instance& inst = session.instance();
+  const double tol = diving.integralityTol;
+  found = false;
+  std::vector<int> fixed;
+  ColumnGenerationResult cg;
+
+  for (size_t depth=0; depth<=diving.maxDepth; ++depth) {
+    SCIP_CALL( run_column_generation(session, options, pool, cg, columnPool) );
+    if (!session.optimal()) break;
+
+    // the largest fractional part is the cheapest column to round up
+    int pick = -1; double pickValue = 0.0, pickFrac = 0.0;
+    for (const auto& entry: session.columns()) {
+      const double v = session.column_value(entry.first);
+      const double frac = v - std::floor(v);
+      if (frac > tol && frac < 1-tol && frac > pickFrac) { pick = entry.first; pickValue = v; pickFrac = frac; }
+    }
+
+    if (pick < 0) {
+      // integral packings with fractional flows are left to the restricted integer master
+      bool flowsIntegral = true;
+      for (size_t r=0; r<inst.R && flowsIntegral; ++r) for (size_t p=0; p<inst.P; ++p)
+        if (!integral(session.flow_value(r,p), tol) || !integral(session.big_m_value(r,p), tol)) { flowsIntegral = false; break; }
+      if (flowsIntegral) { plan_from_session(session, plan); found = true; }
+      break;
+    }
+
+    SCIP_CALL( session.set_column_lower_bound(pick, std::ceil(pickValue)) );
+    fixed.push_back(pick);
+  }
+
+  for (int id: fixed)
+    if (session.columns().count(id)) SCIP_CALL( session.set_column_lower_bound(id, 0.0) );
+  return SCIP_OKAY;
+}
+
+SCIP_RETCODE solve_restricted_integer_master(const Instance& inst, const std::vector<Packing>& columns,
+                                             const IntegerMasterOptions& options, const TransportPlan* start,
+                                             TransportPlan& plan, bool& found)
+{
+  const size_t RP = inst.R*inst.P;
+  found = false;
+
+  SCIP* scip = nullptr;
+  SCIP_CALL( SCIPcreate(&scip) );
+  SCIP_CALL( SCIPincludeDefaultPlugins(scip) );
+  if (!options.verbose) SCIPsetMessagehdlrQuiet(scip, TRUE);
+  if (!options.names) SCIP_CALL( set_lean_parameters(scip) );
+  SCIP_CALL( SCIPsetRealParam(scip, "limits/time", options.timeLimit) );
+  SCIP_CALL( SCIPsetRealParam(scip, "limits/gap", options.gapLimit) );
+  SCIP_CALL( SCIPcreateProbBasic(scip, "LNO_integer_master") );
+
+  // the same names as the branch-and-price model, all empty without options.names
+  EntityNames names(inst, !options.names);
+  auto pairEntity = [&](EntityKind kind, size_t i) { return Entity{kind, (uint32_t)(i/inst.P), (uint32_t)(i%inst.P), 0}; };
+
+  // pairs and flow rows removed by presolve get no variables and constraints
+  std::vector<SCIP_VAR*> f(RP, nullptr), y(RP, nullptr), lambda(columns.size());
+  for (size_t i=0; i<RP; ++i) {
+    if (!inst.pairActive[i]) continue;
+    SCIP_CALL( SCIPcreateVarBasic(scip, &f[i], names.name(pairEntity(EntityKind::Flow, i)), 0.0, SCIPinfinity(scip), 0.0,
+                                  SCIP_VARTYPE_INTEGER) );
+    SCIP_CALL( SCIPaddVar(scip, f[i]) );
+    SCIP_CALL( SCIPcreateVarBasic(scip, &y[i], names.name(pairEntity(EntityKind::InitialY, i)), 0.0, SCIPinfinity(scip), BIG_M,
+                                  SCIP_VARTYPE_INTEGER) );
+    SCIP_CALL( SCIPaddVar(scip, y[i]) );
+  }
+  for (size_t k=0; k<columns.size(); ++k) {
+    const Entity packing{EntityKind::Packing, (uint32_t)columns[k].route, (uint32_t)columns[k].transportResource, (uint32_t)k};
+    SCIP_CALL( SCIPcreateVarBasic(scip, &lambda[k], names.name(packing), 0.0, SCIPinfinity(scip), columns[k].cost,
+                                  SCIP_VARTYPE_INTEGER) );
+    SCIP_CALL( SCIPaddVar(scip, lambda[k]) );
+  }
+
+  // flow conservation == nsd
+  const auto& inc = inst.incidence;
+  for (size_t l=0; l<inst.L; ++l) for (size_t p=0; p<inst.P; ++p) {
+    if (!inst.flow_active(l,p)) continue;
+    const double nsd = inst.netSupplyDemand[inst.lp(l,p)];
+    SCIP_CONS* cons;
+    SCIP_CALL( SCIPcreateConsBasicLinear(scip, &cons, names.lean() ? "" : "flow conservation", 0, nullptr, nullptr, nsd, nsd) );
+    for (size_t k=inc.outStart[l]; k<inc.outStart[l+1]; ++k)
+      if (SCIP_VAR* var = f[inst.rp(inc.outRoutes[k],p)]) SCIP_CALL( SCIPaddCoefLinear(scip, cons, var,  1.0) );
+    for (size_t k=inc.inStart[l];  k<inc.inStart[l+1];  ++k)
+      if (SCIP_VAR* var = f[inst.rp(inc.inRoutes[k],p)])  SCIP_CALL( SCIPaddCoefLinear(scip, cons, var, -1.0) );
+    SCIP_CALL( SCIPaddCons(scip, cons) );
+    SCIP_CALL( SCIPreleaseCons(scip, &cons) );
+  }
+
+  // cover: y - f + sum units * lambda >= 0
+  std::vector<SCIP_CONS*> cover(RP, nullptr);
+  for (size_t i=0; i<RP; ++i) {
+    if (!inst.pairActive[i]) continue;
+    SCIP_CALL( SCIPcreateConsBasicLinear(scip, &cover[i], names.name(pairEntity(EntityKind::Demand, i)), 0, nullptr, nullptr,
+                                         0.0, SCIPinfinity(scip)) );
+    SCIP_CALL( SCIPaddCoefLinear(scip, cover[i], y[i],  1.0) );
+    SCIP_CALL( SCIPaddCoefLinear(scip, cover[i], f[i], -1.0) );
+  }
+  for (size_t k=0; k<columns.size(); ++k)
+    for (const auto& [p, units]: columns[k].items)
+      if (SCIP_CONS* cons = cover[inst.rp(columns[k].route, p)]) SCIP_CALL( SCIPaddCoefLinear(scip, cons, lambda[k], units) );
+  for (auto& cons: cover) {
+    if (!cons) continue;
+    SCIP_CALL( SCIPaddCons(scip, cons) );
+    SCIP_CALL( SCIPreleaseCons(scip, &cons) );
+  }
+
+  // the dive's plan as incumbent, if all of its packings are among the columns
+  if (start) {
+    std::map<PackingKey, size_t> index;
+    for (size_t k=0; k<columns.size(); ++k) index.emplace(key_of(columns[k]), k);
+
+    std::vector<double> fv(RP, 0.0), covered(RP, 0.0), lv(columns.size(), 0.0);
+    bool complete = true;
+    for (const auto& [r, p, units]: start->flows) fv[inst.rp(r,p)] = units;
+    for (const auto& [packing, freq]: start->links) {
+      auto it = index.find(key_of(packing));
+      if (it == index.end()) { complete = false; break; }
+      lv[it->second] += freq;
+      for (const auto& [p, units]: packing.items) covered[inst.rp(packing.route, p)] += units*freq;
+    }
+
+    if (complete) {
+      SCIP_SOL* sol;
+      SCIP_Bool stored;
+      SCIP_CALL( SCIPcreateSol(scip, &sol, nullptr) );
+      for (size_t i=0; i<RP; ++i) {
+        if (!f[i]) continue;
+        SCIP_CALL( SCIPsetSolVal(scip, sol, f[i], fv[i]) );
+        SCIP_CALL( SCIPsetSolVal(scip, sol, y[i], std::max(0.0, fv[i]-covered[i])) );
+      }
+      for (size_t k=0; k<columns.size(); ++k) SCIP_CALL( SCIPsetSolVal(scip, sol, lambda[k], lv[k]) );
+      SCIP_CALL( SCIPaddSolFree(scip, &sol, &stored) );
+    }
+  }
+
+  SCIP_CALL( SCIPsolve(scip) );
+
+  SCIP_SOL* best = SCIPgetBestSol(scip);
+  if (best) {
+    found = true;
+    plan = TransportPlan();
+    for (size_t r=0; r<inst.R; ++r) for (size_t p=0; p<inst.P; ++p) {
+      if (!inst.active(r,p)) continue;
+      const int units = (int)std::lround(SCIPgetSolVal(scip, best, f[inst.rp(r,p)]));
+      if (units > 0) plan.flows.emplace_back((int)r, (int)p, units);
+      plan.uncovered += std::lround(SCIPgetSolVal(scip, best, y[inst.rp(r,p)]));
+    }
+    for (size_t k=0; k<columns.size(); ++k) {
+      const int freq = (int)std::lround(SCIPgetSolVal(scip, best, lambda[k]));
+      if (freq <= 0) continue;
+      plan.links.emplace_back(columns[k], freq);
+      plan.cost += freq*columns[k].cost;
+    }
+  }
+
+  for (auto& var: f) if (var) SCIP_CALL( SCIPreleaseVar(scip, &var) );
+  for (auto& var: y) if (var) SCIP_CALL( SCIPreleaseVar(scip, &var) );
+  for (auto& var: lambda) SCIP_CALL( SCIPreleaseVar(scip, &var) );
+  SCIP_CALL( SCIPfree(&scip) );
+  return SCIP_OKAY;
+}
+
+void write_plan_facts(std::ostream& os, const Instance& inst, const TransportPlan& plan)
+{
+  for (const auto& [r, p, units]: plan.flows) {
+    const Route* route = inst.routes[r];
+    os << "flow(" << route->from->name << "," << route->to->name << "," << inst.products[p]->name << "," << units << ").\n";
+  }
+
+  // equal packings on a route are one link with the summed frequency
+  std::map<std::tuple<int,int,std::string>, int> links;
+  for (const auto& [packing, freq]: plan.links)
+    links[{packing.route, packing.transportResource, packing_list(inst, packing)}] += freq;
+  for (const auto& [key, freq]: links) {
+    const Route* route = inst.routes[std::get<0>(key)];
+    os << "transportLink(" << route->from->name << "," << route->to->name << "," << std::get<2>(key) << ","
+       << inst.transportResources[std::get<1>(key)]->name << "," << freq << ").\n";
+  }
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <ostream>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "column_generation.h"
+
+// Integer transport plan: what travels over each route and which packings carry it how often.
+struct TransportPlan {
+  double cost = 0.0;       // sum of frequency * packing cost
+  double uncovered = 0.0;  // units of flow not covered by a packing (Big-M y), 0 for a complete plan
+  std::vector<std::tuple<int,int,int>> flows;   // (route, product, units), units > 0
+  std::vector<std::pair<Packing,int>> links;    // packing and its frequency, frequency > 0
+};
+
+struct DivingOptions {
+  size_t maxDepth = 1000;       // fixings before giving up
+  double integralityTol = 1e-6;
+};
+
+// Column generation diving: re-run column generation, round the packing column with the
+// largest fractional part (the one closest to its next integer) up by raising its lower
+// bound, repeat until every packing and flow value is integral. Rounding up keeps the cover
+// rows satisfiable, so the dive cannot get stuck in an infeasible RMP. Bounds are released
+// again before returning; found is false if the depth limit was hit. All columns generated
+// on the way stay in the session.
+scip::SCIP_RETCODE dive(RmpSession& session, const ColumnGenerationOptions& options, WorkStealingPool& pool,
+                        ColumnPool* columnPool, const DivingOptions& diving, TransportPlan& plan, bool& found);
+
+struct IntegerMasterOptions {
+  double timeLimit = 60.0;  // seconds
+  double gapLimit = 1e-4;
+  bool   verbose = false;
+  bool   names = true;      // false: nameless variables and constraints, see lean.h
+};
+
+// Restricted integer master: f, y and the frequency of every given packing as integer
+// variables of a MIP solved by SCIP. start (optional, e.g. the dive's plan) is handed to
+// SCIP as initial solution. found is false if SCIP ends without any solution.
+scip::SCIP_RETCODE solve_restricted_integer_master(const Instance& instance, const std::vector<Packing>& columns,
+                                                   const IntegerMasterOptions& options, const TransportPlan* start,
+                                                   TransportPlan& plan, bool& found);
+
+// The plan in the shape of the clingo encodings (optimised_second.lp):
+//   flow(From,To,Part,N).  transportLink(From,To,L,TR,Freq).
+// with L the nested packing list, e.g. (p1,(p2,p2)).
+void write_plan_facts(std::ostream& os, const Instance& instance, const TransportPlan& plan);
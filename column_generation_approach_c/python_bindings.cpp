@@ -0,0 +1,209 @@
+// In-process Python bindings of the RMP core (module lno_core), replacing the lno_rmp_stdin
+// process and its json round trip per iteration in controller.py. Built as the lno_core target
+// of CMakeLists.txt when SCIP and pybind11 are found.
+//
+// The duals come back as read-only NumPy arrays viewing the session's own dual vector: no copy
+// is made, and every solve updates the values in place. Copy an array to keep an old solution.
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include "asp_reader.h"
+#include "column_generation.h"
+#include "instance_loader.h"
+#include "presolve.h"
+#include "rmp_core.h"
+
+namespace py = pybind11;
+using namespace scip;
+
+namespace {
+
+void check(SCIP_RETCODE rc, const char* what)
+{
+  if (rc != SCIP_OKAY) throw std::runtime_error(std::string(what) + " failed with SCIP return code " + std::to_string(rc));
+}
+
+// everything an Instance points into, kept alive by every session built on it
+struct PyInstance {
+  Arena arena;
+  LoadedInstance loaded;
+  Instance instance;
+
+  void build(bool presolve)
+  {
+    instance = build_instance(loaded.settings, loaded.locations, loaded.transportResources, loaded.products, loaded.routes);
+    if (presolve) presolve_instance(instance);
+  }
+
+  // json keys (or fact names) in dense id order
+  template<class Object>
+  static std::vector<std::string> keys(const std::unordered_map<std::string_view, Object*>& byKey, size_t n)
+  {
+    std::vector<std::string> out(n);
+    for (const auto& [key, object]: byKey) out[object->id] = std::string(key);
+    return out;
+  }
+};
+
+std::shared_ptr<PyInstance> from_json(const std::string& text, bool presolve)
+{
+  auto inst = std::make_shared<PyInstance>();
+  std::string error;
+  if (!load_instance_json(std::string_view(text), inst->arena, inst->loaded, error)) throw std::invalid_argument(error);
+  inst->build(presolve);
+  return inst;
+}
+
+std::shared_ptr<PyInstance> from_facts(const std::string& path, double co2Costs, double capitalCosts, bool presolve)
+{
+  auto inst = std::make_shared<PyInstance>();
+  std::string error;
+  if (!load_instance_asp(path.c_str(), Settings(co2Costs, capitalCosts), inst->arena, inst->loaded, error))
+    throw std::invalid_argument(error);
+  inst->build(presolve);
+  return inst;
+}
+
+struct PySession {
+  std::shared_ptr<PyInstance> inst;
+  RmpSession session;
+
+  PySession(std::shared_ptr<PyInstance> instance, bool dualCaps, bool bigM)
+    : inst(std::move(instance)), session(inst->instance)
+  {
+    check(session.init(dualCaps, bigM), "RmpSession::init");
+  }
+
+  int add_column(int route, int tr, const std::map<int,int>& counts)
+  {
+    const Instance& in = inst->instance;
+    if (route < 0 || route >= (int)in.R || tr < 0 || tr >= (int)in.T) throw std::out_of_range("route or transport resource id");
+    Packing packing{route, tr, 0.0, {}, 0.0};
+    size_t k = in.routeTRStart[route];
+    while (k < in.routeTRStart[route+1] && in.routeTR[k] != tr) ++k;
+    if (k == in.routeTRStart[route+1]) throw std::invalid_argument("transport resource not on route");
+    packing.distance = in.routeDistance[k];
+    for (const auto& [p, units]: counts) {
+      if (p < 0 || p >= (int)in.P) throw std::out_of_range("product id");
+      if (units > 0) packing.items.emplace_back(p, units);
+    }
+    packing.cost = packing_cost(in, tr, packing.distance, packing.items);
+    int id = -1;
+    check(session.add_column(packing, &id), "RmpSession::add_column");
+    return id;
+  }
+
+  // read-only row-major view of the doubles at data, keeping the session object alive
+  static py::array_t<double> view(py::object owner, const double* data, std::vector<py::ssize_t> shape)
+  {
+    std::vector<py::ssize_t> strides(shape.size(), (py::ssize_t)sizeof(double));
+    for (size_t i=shape.size()-1; i>0; --i) strides[i-1] = strides[i]*shape[i];
+    py::array_t<double> array(shape, strides, data, owner);
+    array.attr("setflags")(py::arg("write") = false);
+    return array;
+  }
+};
+
+py::dict result_dict(const ColumnGenerationResult& r)
+{
+  py::dict d;
+  d["optimal"] = r.optimal; d["objective"] = r.objective; d["lower_bound"] = r.lowerBound; d["gap"] = r.gap;
+  d["rounds"] = r.rounds; d["columns"] = r.columns; d["lp_iterations"] = r.lpIterations;
+  d["gap_closed"] = r.gapClosed; d["tailing_off"] = r.tailingOff; d["farkas_rounds"] = r.farkasRounds;
+  return d;
+}
+
+} // namespace
+
+PYBIND11_MODULE(lno_core, m)
+{
+  m.doc() = "RMP core of the logistics network optimization: instance loading, LP sessions, duals";
+
+  py::class_<PyInstance, std::shared_ptr<PyInstance>>(m, "Instance")
+    .def_static("from_json", &from_json, py::arg("text"), py::arg("presolve") = false,
+                "instance in the json format of lno_rmp_stdin")
+    .def_static("from_facts", &from_facts, py::arg("path"), py::arg("co2Costs") = FACT_FORMAT_SETTINGS.co2Costs,
+                py::arg("capitalCosts") = FACT_FORMAT_SETTINGS.capitalCosts, py::arg("presolve") = false, "instance from an ASP fact file")
+    .def_property_readonly("L", [](const PyInstance& i) { return i.instance.L; })
+    .def_property_readonly("T", [](const PyInstance& i) { return i.instance.T; })
+    .def_property_readonly("P", [](const PyInstance& i) { return i.instance.P; })
+    .def_property_readonly("R", [](const PyInstance& i) { return i.instance.R; })
+    .def_property_readonly("location_keys", [](const PyInstance& i) { return PyInstance::keys(i.loaded.locationKeys, i.instance.L); })
+    .def_property_readonly("transport_resource_keys",
+                           [](const PyInstance& i) { return PyInstance::keys(i.loaded.transportResourceKeys, i.instance.T); })
+    .def_property_readonly("product_keys", [](const PyInstance& i) { return PyInstance::keys(i.loaded.productKeys, i.instance.P); })
+    .def_property_readonly("route_keys", [](const PyInstance& i) { return PyInstance::keys(i.loaded.routeKeys, i.instance.R); })
+    .def_property_readonly("location_names", [](const PyInstance& i) {
+      std::vector<std::string> names;
+      for (const auto* l: i.instance.locations) names.emplace_back(l->name);
+      return names;
+    })
+    .def_property_readonly("product_names", [](const PyInstance& i) {
+      std::vector<std::string> names;
+      for (const auto* p: i.instance.products) names.emplace_back(p->name);
+      return names;
+    })
+    .def_property_readonly("route_ends", [](const PyInstance& i) {
+      std::vector<std::pair<std::string, std::string>> ends;
+      for (const auto* r: i.instance.routes) ends.emplace_back(r->from->name, r->to->name);
+      return ends;
+    });
+
+  py::class_<PySession>(m, "Session")
+    .def(py::init<std::shared_ptr<PyInstance>, bool, bool>(), py::arg("instance"), py::arg("dual_caps") = false,
+         py::arg("big_m") = true)
+    .def("add_column", &PySession::add_column, py::arg("route"), py::arg("tr"), py::arg("counts"),
+         "packing column {product id: units} on a route, costed as in pricing; returns its id")
+    .def("remove_columns", [](PySession& s, const std::vector<int>& ids) {
+      check(s.session.remove_columns(ids), "RmpSession::remove_columns");
+    })
+    .def("solve", [](PySession& s) {
+      SCIP_RETCODE rc;
+      {
+        py::gil_scoped_release release;
+        rc = s.session.solve();
+      }
+      check(rc, "RmpSession::solve");
+      return s.session.optimal();
+    }, "re-optimizes from the previous basis; True if optimal")
+    .def("column_generation", [](PySession& s, size_t threads, size_t maxRounds, double gap) {
+      ColumnGenerationOptions options;
+      options.pricing.threads = threads;
+      options.maxRounds = maxRounds;
+      options.convergence.gap = gap;
+      ColumnGenerationResult result;
+      SCIP_RETCODE rc;
+      {
+        py::gil_scoped_release release;
+        WorkStealingPool pool(threads);
+        rc = run_column_generation(s.session, options, pool, result);
+      }
+      check(rc, "run_column_generation");
+      return result_dict(result);
+    }, py::arg("threads") = 1, py::arg("max_rounds") = 0, py::arg("gap") = 0.0,
+       "prices in-process until no packing improves (or the gap is closed)")
+    .def_property_readonly("optimal", [](const PySession& s) { return s.session.optimal(); })
+    .def_property_readonly("infeasible", [](const PySession& s) { return s.session.infeasible(); })
+    .def_property_readonly("objective", [](const PySession& s) { return s.session.objective(); })
+    .def_property_readonly("iterations", [](const PySession& s) { return s.session.iterations(); })
+    .def("column_value", [](const PySession& s, int id) { return s.session.column_value(id); })
+    .def_property_readonly("flow_duals", [](py::object self) {
+      const PySession& s = self.cast<const PySession&>();
+      const Instance& in = s.inst->instance;
+      return PySession::view(self, s.session.duals().data(), {(py::ssize_t)in.L, (py::ssize_t)in.P});
+    }, "flow conservation duals [location, product], a view updated by every solve")
+    .def_property_readonly("cover_duals", [](py::object self) {
+      const PySession& s = self.cast<const PySession&>();
+      const Instance& in = s.inst->instance;
+      return PySession::view(self, s.session.cover_duals(), {(py::ssize_t)in.R, (py::ssize_t)in.P});
+    }, "cover duals [route, product], a view updated by every solve")
+    .def_property_readonly("cover_farkas", [](py::object self) {
+      const PySession& s = self.cast<const PySession&>();
+      const Instance& in = s.inst->instance;
+      return PySession::view(self, s.session.cover_farkas(), {(py::ssize_t)in.R, (py::ssize_t)in.P});
+    }, "Farkas multipliers of the cover rows after an infeasible solve [route, product]");
+}
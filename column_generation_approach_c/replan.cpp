@@ -0,0 +1,55 @@
+#include "replan.h"
+using namespace scip;
+
+Replanner::Replanner(Instance& instance, RmpSession& session)
+  : inst_(instance), session_(session)
+{}
+
+SCIP_RETCODE Replanner::set_net_supply_demand(size_t location, size_t product, int value)
+{
+  if (location >= inst_.L || product >= inst_.P) return SCIP_INVALIDDATA;
+  const int old = inst_.netSupplyDemand[inst_.lp(location, product)];
+  if (inst_.presolved && value != 0 && (old == 0 || (old > 0) != (value > 0))) return SCIP_INVALIDDATA;
+  SCIP_CALL( session_.set_flow_rhs(location, product, value) );
+  inst_.netSupplyDemand[inst_.lp(location, product)] = value;
+  return SCIP_OKAY;
+}
+
+SCIP_RETCODE Replanner::set_route_enabled(size_t route, bool enabled)
+{
+  if (route >= inst_.R) return SCIP_INVALIDDATA;
+  if ((inst_.routeEnabled[route] != 0) == enabled) return SCIP_OKAY;
+  inst_.routeEnabled[route] = enabled;
+
+  const double ub = enabled ? session_.infinity() : 0.0;
+  for (size_t p=0; p<inst_.P; ++p) SCIP_CALL( session_.set_flow_upper_bound(route, p, ub) );
+  return update_column_bounds((int)route, -1);
+}
+
+SCIP_RETCODE Replanner::set_transport_resource_enabled(size_t tr, bool enabled)
+{
+  if (tr >= inst_.T) return SCIP_INVALIDDATA;
+  if ((inst_.trEnabled[tr] != 0) == enabled) return SCIP_OKAY;
+  if (inst_.presolved) return SCIP_INVALIDDATA;
+  inst_.trEnabled[tr] = enabled;
+  return update_column_bounds(-1, (int)tr);
+}
+
+SCIP_RETCODE Replanner::set_settings(const Settings& settings)
+{
+  if (inst_.presolved && settings.co2Costs != inst_.settings.co2Costs) return SCIP_INVALIDDATA;
+  inst_.settings = settings;
+  for (const auto& [id, packing]: session_.columns())
+    SCIP_CALL( session_.set_column_cost(id, packing_cost(inst_, packing.transportResource, packing.distance, packing.items)) );
+  return SCIP_OKAY;
+}
+
+SCIP_RETCODE Replanner::update_column_bounds(int route, int tr)
+{
+  const double inf = session_.infinity();
+  for (const auto& [id, packing]: session_.columns()) {
+    if (packing.route != route && packing.transportResource != tr) continue;
+    SCIP_CALL( session_.set_column_upper_bound(id, inst_.enabled(packing.route, packing.transportResource) ? inf : 0.0) );
+  }
+  return SCIP_OKAY;
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include "rmp_core.h"
+
+// Incremental replanning on a live session: every change is applied to the instance and, in
+// place, to the session's LP (right-hand sides, bounds, costs), so the next solve or column
+// generation run restarts from the previous basis and keeps every generated column.
+//
+// The session must have been built on this instance. Changes that need a row or slot presolve
+// removed (supply or demand at a location it pruned, a transport resource or CO2 rate its slot
+// dominance depended on) return SCIP_INVALIDDATA; rebuild the session then.
+class Replanner {
+public:
+  Replanner(Instance& instance, RmpSession& session);
+
+  // net supply (> 0) or demand (< 0) of a product at a location. On a presolved instance the
+  // kept pairs only connect the supplies and demands it saw, so a value that turns a location
+  // into a new supply or demand (its sign changes to > 0 or < 0) returns SCIP_INVALIDDATA and
+  // needs a rebuild from the unpresolved instance; shrinking a value towards 0 is fine
+  scip::SCIP_RETCODE set_net_supply_demand(size_t location, size_t product, int value);
+
+  // a disabled route carries no flow, a disabled transport resource no packing;
+  // their columns stay in the LP at upper bound 0 and pricing skips them. Presolve only kept
+  // the dominating transport resource of each route, so switching one on a presolved instance
+  // returns SCIP_INVALIDDATA
+  scip::SCIP_RETCODE set_route_enabled(size_t route, bool enabled);
+  scip::SCIP_RETCODE set_transport_resource_enabled(size_t tr, bool enabled);
+
+  // CO2 and capital cost rates; every packing column is re-costed. The slot dominance of
+  // presolve compares trip costs at the CO2 rate, so a new co2Costs on a presolved instance
+  // returns SCIP_INVALIDDATA; the capital cost rate is free to change
+  scip::SCIP_RETCODE set_settings(const Settings& settings);
+
+private:
+  // upper bounds of the packing columns from the route and transport resource switches
+  scip::SCIP_RETCODE update_column_bounds(int route, int tr);
+
+  Instance& inst_;
+  RmpSession& session_;
+};
@@ -3,8 +3,12 @@
 //
 
 /* standard library includes */
+#include <cmath>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <optional>
+#include <string>
 
 /* scip includes */
 #include "objscip/objscip.h"
@@ -12,20 +16,38 @@
 
 /* user defined includes */
 #include "main.h"
+#include "arena.h"
+#include "asp_reader.h"
+#include "column_pool.h"
+#include "convergence.h"
+#include "greedy_start.h"
+#include "instance.h"
+#include "instance_loader.h"
+#include "lean.h"
+#include "presolve.h"
 #include "pricer_knapsack.h"
-#include <nlohmann/json.hpp>
-
-using json = nlohmann::json;
+#include "primal_heuristic.h"
+#include "stats.h"
 
 /* namespace usage */
 using namespace std;
 using namespace scip;
 
-/** read LNO problem */
-static int read_problem(const char *filename, Settings &settings,
-                        vector<Location *> &locations,
-                        vector<TransportResource *> &transportResources,
-                        vector<Product *> &products, vector<Route *> &routes) {
+/** read LNO problem, all domain objects are allocated in the arena
+ *
+ *  Files ending in .lp are read as ASP facts, everything else as json.
+ */
+static int read_problem(const char *filename, Arena &arena, LoadedInstance &problem) {
+  string error;
+  const string name(filename);
+  if (name.size() > 3 && name.compare(name.size() - 3, 3, ".lp") == 0) {
+    if (!load_instance_asp(filename, FACT_FORMAT_SETTINGS, arena, problem, error)) {
+      cerr << error << endl;
+      return 1;
+    }
+    return 0;
+  }
+
   ifstream file(filename);
 
   if (!file) {
@@ -33,77 +55,9 @@ static int read_problem(const char *filename, Settings &settings,
     return 1;
   }
 
-  json data = json::parse(file);
-  // cout << data.dump(4) << endl;
-
-  struct Linkings {
-    unordered_map<string, Location *> locations;
-    unordered_map<string, TransportResource *> transportResources;
-    unordered_map<string, Product *> products;
-    unordered_map<string, Route *> routes;
-  };
-  Linkings linkings;
-
-  settings.co2Costs = data.at("settings").at("co2Costs");
-  settings.capitalCosts = data.at("settings").at("capitalCosts");
-
-  for (auto i = data.at("locations").begin(); i != data.at("locations").end();
-       ++i) {
-    auto *location = new Location(i.value().at("name"));
-    linkings.locations[i.key()] = location;
-    locations.push_back(location);
-  }
-
-  for (auto i = data.at("transportResources").begin();
-       i != data.at("transportResources").end(); ++i) {
-    auto *transportResource =
-        new TransportResource(i.value().at("name"), i.value().at("capacity"),
-                              i.value().at("co2Emissions"),
-                              i.value().at("cost"), i.value().at("speed"));
-    linkings.transportResources[i.key()] = transportResource;
-    transportResources.push_back(transportResource);
-  }
-
-  for (auto i = data.at("products").begin(); i != data.at("products").end();
-       ++i) {
-    vector<TransportResource *> validTR;
-    for (auto &tr : i.value().at("validTR")) {
-      validTR.push_back(linkings.transportResources[tr]);
-    }
-
-    map<Location *, int> netSupplyDemand;
-    for (auto j = i.value().at("netSupplyDemand").begin(); j != i.value().at("netSupplyDemand").end(); ++j) {
-        netSupplyDemand[linkings.locations[j.key()]] = j.value();
-    }
-
-    auto *product = new Product(i.value().at("name"), validTR, i.value().at("size"), i.value().at("value"), netSupplyDemand);
-
-    linkings.products[i.key()] = product;
-    products.push_back(product);
-  }
-
-  for (auto i = data.at("routes").begin(); i != data.at("routes").end(); ++i) {
-    /*
-    "transportResources": {
-        "TR1": {
-          "distance": 2
-        },
-        "TR2": {
-          "distance": 4
-        }
-      }
-      */
-    vector<tuple<TransportResource*, double>> transportResources;
-    for (auto tr = i.value().at("transportResources").begin(); tr != i.value().at("transportResources").end(); ++tr) {
-        transportResources.push_back(make_tuple(linkings.transportResources[tr.key()], tr.value().at("distance")));
-    }
-    
-    auto *route = new Route(
-        linkings.locations[i.value().at("to")],
-        linkings.locations[i.value().at("from")],
-        transportResources);
-    linkings.routes[i.key()] = route;
-    routes.push_back(route);
+  if (!load_instance_json(file, arena, problem, error)) {
+    cerr << error << endl;
+    return 1;
   }
 
   return 0;
@@ -119,26 +73,90 @@ static SCIP_RETCODE execmain(int argc, char **argv) {
   cout << "Solving the logistics network optimization problem using SCIP."
        << endl;
 
-  if (argc != 2) {
-    cerr << "Usage: lno datafile" << endl;
+  PricingOptions pricing;
+  string poolFile;
+  string planFile;
+  string statsFile;
+  bool statsStream = false;
+  bool presolve = false;
+  bool greedy = false;
+  bool farkas = false;
+  ConvergenceOptions convergence;
+  bool lean = false;
+  double memoryLimit = 0;
+  bool usage = argc < 2;
+  for (int i = 1; i < argc - 1 && !usage; ++i) {
+    string option = argv[i];
+    if (option == "--threads" && i + 2 < argc)
+      pricing.threads = (size_t)atoi(argv[++i]);
+    else if (option == "--pool" && i + 2 < argc)
+      poolFile = argv[++i];
+    else if (option == "--plan" && i + 2 < argc)
+      planFile = argv[++i];
+    else if (option == "--stats" && i + 2 < argc)
+      statsFile = argv[++i];
+    else if (option == "--stats-stream")
+      statsStream = true;
+    else if (option == "--presolve")
+      presolve = true;
+    else if (option == "--greedy")
+      greedy = true;
+    else if (option == "--farkas")
+      farkas = true;
+    else if (option == "--lean")
+      lean = true;
+    else if (option == "--mem-limit" && i + 2 < argc)
+      memoryLimit = atof(argv[++i]);
+    else if (option == "--gap" && i + 2 < argc)
+      convergence.gap = atof(argv[++i]);
+    else if (option == "--tailing" && i + 3 < argc) {
+      convergence.tailingRounds = (size_t)atoi(argv[++i]);
+      convergence.tailingImprovement = atof(argv[++i]);
+    }
+    else
+      usage = true;
+  }
+  if (usage) {
+    cerr << "Usage: lno [--threads N] [--pool file] [--plan file] [--stats file] [--stats-stream] "
+            "[--presolve] [--greedy] [--farkas] [--gap rel] [--tailing rounds rel] "
+            "[--lean] [--mem-limit MB] datafile"
+         << endl;
     return SCIP_INVALIDDATA;
   }
 
+  /* timers and counters, written as json to the stats file, rounds streamed to stderr */
+  Stats stats;
+  Stats *stats_ptr = (!statsFile.empty() || statsStream) ? &stats : nullptr;
+  if (statsStream)
+    stats.stream_rounds(&cerr);
+
   /**********************
    * Setup problem data *
    **********************/
 
-  Settings settings;
-  vector<Location *> locations;
-  vector<TransportResource *> transportResources;
-  vector<Product *> products;
+  Arena arena;
+  LoadedInstance problem;
 
-  vector<Route *> routes;
+  {
+    ScopedTimer timer(stats_ptr, "load");
+    if (read_problem(argv[argc - 1], arena, problem)) {
+      cerr << "Error reading data file " << argv[argc - 1] << endl;
+      return SCIP_READERROR;
+    }
+  }
 
-  if (read_problem(argv[argc - 1], settings, locations, transportResources,
-                   products, routes)) {
-    cerr << "Error reading data file " << argv[argc - 1] << endl;
-    return SCIP_READERROR;
+  optional<ScopedTimer> build_timer;
+  build_timer.emplace(stats_ptr, "build");
+
+  Instance instance = build_instance(problem.settings, problem.locations,
+                                     problem.transportResources, problem.products,
+                                     problem.routes);
+  if (presolve) {
+    ScopedTimer timer(stats_ptr, "presolve");
+    PresolveStats reduction = presolve_instance(instance);
+    print_presolve_stats(cout, reduction);
+    stats.count("presolve_pairs_removed", (long)(reduction.pairsBefore - reduction.pairsAfter));
+    stats.count("presolve_slots_removed", (long)(reduction.slotsBefore - reduction.slotsAfter));
   }
 
   /**************
@@ -162,51 +180,65 @@ static SCIP_RETCODE execmain(int argc, char **argv) {
   // SCIP_CALL( SCIPsetIntParam(scip, "display/verblevel", 0) );
   /* SCIP_CALL( SCIPsetBoolParam(scip, "display/lpinfo", TRUE) ); */
 
+  /* lean mode: nameless entities, recorded for the solution output only, and small SCIP tables */
+  EntityNames names(instance, lean);
+  if (lean)
+    SCIP_CALL(set_lean_parameters(scip, memoryLimit));
+  else if (memoryLimit > 0)
+    SCIP_CALL(SCIPsetRealParam(scip, "limits/memory", memoryLimit));
+
   /* create empty problem */
   SCIP_CALL(SCIPcreateProbBasic(scip, "LNO"));
 
-  // flow variables
-  map<tuple<Route *, Product *>, SCIP_VAR *> flow_vars;
-  for (const auto &route : routes) {
-    for (const auto &product : products) {
+  // flow variables, indexed by instance.rp(route, product)
+  vector<SCIP_VAR *> flow_vars(instance.R * instance.P, nullptr);
+  for (size_t r = 0; r < instance.R; ++r) {
+    for (size_t p = 0; p < instance.P; ++p) {
+      if (!instance.active(r, p))
+        continue;
+
       SCIP_VAR *var;
-      char flow_var_name[255];
-      (void)SCIPsnprintf(flow_var_name, 255, "flow_%s->%s_%s",
-                         route->from->name.c_str(), route->to->name.c_str(),
-                         product->name.c_str());
+      const Entity flow{EntityKind::Flow, (uint32_t)r, (uint32_t)p};
 
       SCIP_CALL(SCIPcreateVarBasic(
           scip, &var,         // returns new index
-          flow_var_name,      // name
+          names.name(flow),   // name
           0,                  // lower bound
           SCIPinfinity(scip), // upper bound
           0,                   // objective
           SCIP_VARTYPE_CONTINUOUS)); // variable type
+      names.record(var, flow);
       SCIP_CALL(SCIPaddVar(scip, var));
-      flow_vars[make_tuple(route, product)] = var;
+      flow_vars[instance.rp(r, p)] = var;
     }
   }
 
-  // add flow conservation constraints
-  for (const auto &location : locations) {
-    for (const auto &product : products) {
-      int flow_amount = product->netSupplyDemand[location];
+  // add flow conservation constraints, visiting only the routes incident to each location
+  const LocationIncidence &incidence = instance.incidence;
+  for (size_t l = 0; l < instance.L; ++l) {
+    for (size_t p = 0; p < instance.P; ++p) {
+      if (!instance.flow_active(l, p))
+        continue;
+
+      int flow_amount = instance.netSupplyDemand[instance.lp(l, p)];
 
       SCIP_CONS *cons;
-      SCIP_CALL(SCIPcreateConsBasicLinear(scip, &cons, "flow conservation", 0,
+      SCIP_CALL(SCIPcreateConsBasicLinear(scip, &cons, lean ? "" : "flow conservation", 0,
                                           nullptr, nullptr,
                                           flow_amount,   /* lhs */
                                           flow_amount)); /* rhs */
       SCIP_CALL(SCIPaddCons(scip, cons));
 
-      for (const auto &route : routes) {
-        if (route->from == location)
-          SCIP_CALL(SCIPaddCoefLinear(
-              scip, cons, flow_vars[make_tuple(route, product)], 1));
+      for (size_t k = incidence.outStart[l]; k < incidence.outStart[l + 1]; ++k) {
+        SCIP_VAR *var = flow_vars[instance.rp(incidence.outRoutes[k], p)];
+        if (var != nullptr)
+          SCIP_CALL(SCIPaddCoefLinear(scip, cons, var, 1));
+      }
 
-        else if (route->to == location)
-          SCIP_CALL(SCIPaddCoefLinear(
-              scip, cons, flow_vars[make_tuple(route, product)], -1));
+      for (size_t k = incidence.inStart[l]; k < incidence.inStart[l + 1]; ++k) {
+        SCIP_VAR *var = flow_vars[instance.rp(incidence.inRoutes[k], p)];
+        if (var != nullptr)
+          SCIP_CALL(SCIPaddCoefLinear(scip, cons, var, -1));
       }
 
       // release constraint
@@ -214,37 +246,38 @@ static SCIP_RETCODE execmain(int argc, char **argv) {
     }
   }
 
-  /* add flow amount constraints */
-  map<tuple<Route *, Product *>, SCIP_CONS *> demand_con;
-  for (const auto &route : routes) {
-    for (const auto &product : products) {
+  /* add flow amount constraints, indexed by instance.rp(route, product) */
+  vector<SCIP_CONS *> demand_con(instance.R * instance.P, nullptr);
+  for (size_t r = 0; r < instance.R; ++r) {
+    for (size_t p = 0; p < instance.P; ++p) {
+      if (!instance.active(r, p))
+        continue;
+
       SCIP_CONS *con;
-      char demand_con_name[255];
-      (void)SCIPsnprintf(demand_con_name, 255, "demand_%s->%s_%s",
-                         route->from->name.c_str(), route->to->name.c_str(),
-                         product->name.c_str());
-      SCIP_CALL(SCIPcreateConsBasicLinear(scip, &con, demand_con_name, 0, nullptr, nullptr, 
+      SCIP_CALL(SCIPcreateConsBasicLinear(scip, &con, names.name({EntityKind::Demand, (uint32_t)r, (uint32_t)p}),
+                                          0, nullptr, nullptr, 
                                           0.0, /* lhs */
                                           SCIPinfinity(scip)));                 /* rhs */
       SCIP_CALL(SCIPsetConsModifiable(scip, con, true));
       SCIP_CALL(SCIPaddCons(scip, con));
-      demand_con[make_tuple(route, product)] = con;
+      demand_con[instance.rp(r, p)] = con;
+
+      SCIP_CALL(SCIPaddCoefLinear(scip, con, flow_vars[instance.rp(r, p)], -1));
 
-      SCIP_CALL(SCIPaddCoefLinear(scip, con, flow_vars[make_tuple(route, product)], -1));
-      SCIP_CALL(SCIPreleaseVar(scip, &flow_vars[make_tuple(route, product)]));
+      /* with Farkas pricing the constraint starts uncovered, the pricer repairs the infeasible LP */
+      if (farkas)
+        continue;
 
       SCIP_VAR *var;
-      char y_var_name[255];
-      (void)SCIPsnprintf(y_var_name, 255, "initial-y_%s->%s_%s",
-                         route->from->name.c_str(), route->to->name.c_str(),
-                         product->name.c_str());
+      const Entity y{EntityKind::InitialY, (uint32_t)r, (uint32_t)p};
 
       SCIP_CALL(SCIPcreateVarBasic(
-          scip, &var, y_var_name, // name
+          scip, &var, names.name(y), // name
           0.0,                     // lower bound
           SCIPinfinity(scip),      // upper bound
           pow(10,6),   // objective
           SCIP_VARTYPE_CONTINUOUS)); // variable type
+      names.record(var, y);
       SCIP_CALL(SCIPaddVar(scip, var));
 
       SCIP_CALL(SCIPaddCoefLinear(scip, con, var, 1));
@@ -255,7 +288,56 @@ static SCIP_RETCODE execmain(int argc, char **argv) {
   static const char *PRICER_KNAPSACK_NAME = "Knapsack Pricer";
 
   /* include LNO pricer */
-  auto *lno_pricer_ptr = new PricerKnapsack(scip, PRICER_KNAPSACK_NAME, routes, products, settings, demand_con);
+  auto *lno_pricer_ptr = new PricerKnapsack(scip, PRICER_KNAPSACK_NAME, instance, demand_con, pricing);
+
+  /* patterns of earlier runs are tried before any knapsack is solved */
+  ColumnPool column_pool(instance);
+  if (!poolFile.empty()) {
+    string error;
+    size_t skipped = 0;
+    if (column_pool.load(poolFile, error, &skipped))
+      cout << "Column pool: " << column_pool.size() << " patterns loaded, " << skipped
+           << " not applicable" << endl;
+    lno_pricer_ptr->set_column_pool(&column_pool);
+  }
+
+  lno_pricer_ptr->set_stats(stats_ptr);
+  lno_pricer_ptr->set_entity_names(&names);
+  if (convergence.gap > 0 || convergence.tailingRounds > 0)
+    lno_pricer_ptr->set_convergence(convergence);
+
+  /* greedy packings as initial columns, a complete greedy plan also as first primal solution */
+  if (greedy) {
+    ScopedTimer timer(stats_ptr, "greedy");
+    TransportPlan plan;
+    const bool complete = greedy_plan(instance, plan);
+    vector<Packing> packings;
+    for (const auto &link : plan.links)
+      packings.push_back(link.first);
+    vector<SCIP_VAR *> packing_vars;
+    SCIP_CALL(lno_pricer_ptr->add_initial_columns(scip, packings, packing_vars));
+
+    if (complete) {
+      SCIP_SOL *sol;
+      SCIP_Bool stored;
+      SCIP_CALL(SCIPcreateSol(scip, &sol, nullptr));
+      for (const auto &[r, p, units] : plan.flows)
+        SCIP_CALL(SCIPsetSolVal(scip, sol, flow_vars[instance.rp(r, p)], units));
+      for (size_t k = 0; k < packing_vars.size(); ++k)
+        SCIP_CALL(SCIPsetSolVal(scip, sol, packing_vars[k], plan.links[k].second));
+      SCIP_CALL(SCIPaddSolFree(scip, &sol, &stored));
+      cout << "Greedy start: cost " << plan.cost << ", " << packings.size() << " columns" << endl;
+    } else {
+      cout << "Greedy start: not every demand routed, " << packings.size() << " columns" << endl;
+    }
+
+    for (auto &var : packing_vars)
+      SCIP_CALL(SCIPreleaseVar(scip, &var));
+  }
+
+  for (auto &var : flow_vars)
+    if (var != nullptr)
+      SCIP_CALL(SCIPreleaseVar(scip, &var));
 
   SCIP_CALL(SCIPincludeObjPricer(scip, lno_pricer_ptr, true));
 
@@ -269,24 +351,69 @@ static SCIP_RETCODE execmain(int argc, char **argv) {
    *  Solve    *
    *************/
 
-  SCIP_CALL(SCIPsolve(scip));
+  build_timer.reset();
+  {
+    ScopedTimer timer(stats_ptr, "solve");
+    SCIP_CALL(SCIPsolve(scip));
+  }
 
   /**************
    * Statistics *
    *************/
   SCIP_CALL(SCIPprintStatistics(scip, nullptr));
 
-  SCIP_CALL(SCIPprintBestSol(scip, nullptr, FALSE));
+  if (lean)
+    names.print_solution(scip, SCIPgetBestSol(scip), cout);
+  else
+    SCIP_CALL(SCIPprintBestSol(scip, nullptr, FALSE));
+
+  /* peak memory of the whole process and what SCIP holds, per variable incl. the priced ones */
+  const long peakRss = peak_rss_bytes();
+  const long nVars = (long)SCIPgetNOrigVars(scip) + SCIPgetNPricevars(scip);
+  cout << "Memory: peak RSS " << peakRss / 1048576.0 << " MB, SCIP " << SCIPgetMemUsed(scip) / 1048576.0
+       << " MB in use (" << SCIPgetMemTotal(scip) / 1048576.0 << " MB allocated), " << nVars << " variables, "
+       << (nVars > 0 ? peakRss / nVars : 0) << " bytes per variable" << endl;
+  stats.count("peak_rss_bytes", peakRss);
+
+  if (!poolFile.empty() && !column_pool.save(poolFile))
+    cerr << "Error writing column pool " << poolFile << endl;
+
+  /* integer plan from the priced columns, written as flow/4 and transportLink/5 facts */
+  if (!planFile.empty()) {
+    ScopedTimer timer(stats_ptr, "integer_master");
+    TransportPlan plan;
+    bool found = false;
+    IntegerMasterOptions masterOptions;
+    masterOptions.names = !lean;
+    SCIP_CALL(solve_restricted_integer_master(instance, lno_pricer_ptr->columns(), masterOptions, nullptr,
+                                              plan, found));
+    ofstream planOut(planFile);
+    if (found && planOut) {
+      write_plan_facts(planOut, instance, plan);
+      cout << "Plan cost: " << plan.cost << ", uncovered units: " << plan.uncovered << endl;
+    } else {
+      cerr << "No integer plan written to " << planFile << endl;
+    }
+  }
+
+  if (!statsFile.empty()) {
+    stats.count("lp_iterations", (long)SCIPgetNLPIterations(scip));
+    stats.count("priced_vars", SCIPgetNPricevars(scip));
+    ofstream statsOut(statsFile);
+    if (statsOut)
+      stats.write_json(statsOut);
+    else
+      cerr << "Error writing stats " << statsFile << endl;
+  }
 
   /********************
    * Deinitialization *
    ********************/
 
-  /* release variables */
-  for (const auto &route : routes) {
-    for (const auto &product : products) {
-      SCIP_CALL(SCIPreleaseCons(scip, &demand_con[make_tuple(route, product)]));
-    }
+  /* release constraints */
+  for (auto &con : demand_con) {
+    if (con != nullptr)
+      SCIP_CALL(SCIPreleaseCons(scip, &con));
   }
 
   SCIP_CALL(SCIPfree(&scip));
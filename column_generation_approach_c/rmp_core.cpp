@@ -1,97 +1,380 @@
 #include "rmp_core.h"
 #include "objscip/objscip.h"
-#include "objscip/objscipdefplugins.h"
+#include "lpi/lpi.h"
+#include <algorithm>
 #include <map>
 #include <tuple>
 #include <cmath>
 #include <iostream>
 using namespace scip;
 
-SCIP_RETCODE solve_rmp_from_data(
-    const Settings& settings,
-    const std::vector<Location*>& locations,
-    const std::vector<TransportResource*>& transportResources,
-    const std::vector<Product*>& products,
-    const std::vector<Route*>& routes)
-{
-  SCIP* scip = nullptr;
-  SCIP_CALL( SCIPcreate(&scip) );
-  SCIPprintVersion(scip, nullptr); SCIPinfoMessage(scip,nullptr,"\n");
-  SCIP_CALL( SCIPincludeDefaultPlugins(scip) );
-  SCIP_CALL( SCIPcreateProbBasic(scip, "RMP") );
-
-  // Vars f and Big-M y
-  std::map<std::tuple<Route*,Product*>, SCIP_VAR*> fvar;
-  for (auto* route: routes) for (auto* prod: products) {
-    SCIP_VAR* v=nullptr; char nm[255];
-    (void)SCIPsnprintf(nm,255,"f_%s->%s_%s",
-      route->from->name.c_str(), route->to->name.c_str(), prod->name.c_str());
-    SCIP_CALL(SCIPcreateVarBasic(scip,&v,nm,0.0,SCIPinfinity(scip),0.0,SCIP_VARTYPE_CONTINUOUS));
-    SCIP_CALL(SCIPaddVar(scip,v));
-    fvar[{route,prod}] = v;
+static const double BIG_M = 1e6;
+
+RmpSession::RmpSession(const Instance& instance)
+  : inst_(instance), L_(instance.L), P_(instance.P), R_(instance.R)
+{}
+
+RmpSession::~RmpSession() {
+  if (lpi_) (void)SCIPlpiFree(&lpi_);
+}
+
+SCIP_RETCODE RmpSession::init(bool dualCaps, bool bigM)
+{
+  SCIP_CALL( SCIPlpiCreate(&lpi_, nullptr, "RMP", SCIP_OBJSENSE_MINIMIZE) );
+  const double inf = SCIPlpiInfinity(lpi_);
+
+  // dense ids -> LP positions of the entries presolve kept
+  pairIndex_.assign(R_*P_, -1);
+  flowRow_.assign(L_*P_, -1);
+  pairs_ = flowRows_ = 0;
+  for (size_t i=0; i<R_*P_; ++i) if (inst_.pairActive[i]) pairIndex_[i] = (int)pairs_++;
+  for (size_t i=0; i<L_*P_; ++i) if (inst_.flowActive[i]) flowRow_[i] = (int)flowRows_++;
+  const size_t K = pairs_;
+  // sized once here; scatter_rows only overwrites the values, so pointers into them stay valid
+  duals_.assign(L_*P_ + R_*P_, 0.0);
+  farkas_.assign(L_*P_ + R_*P_, 0.0);
+
+  // Vars f (free of cost) and Big-M y, one each per active route x product; a disabled route
+  // starts closed, as Replanner::set_route_enabled would leave it
+  bigM_ = bigM;
+  const size_t nvars = (bigM ? 2 : 1)*K;
+  std::vector<double> obj(nvars, 0.0), lb(nvars, 0.0), ub(nvars, inf);
+  for (size_t k=K; k<nvars; ++k) obj[k] = BIG_M;
+  for (size_t i=0; i<R_*P_; ++i) if (pairIndex_[i] >= 0 && !inst_.routeEnabled[i/P_]) ub[pairIndex_[i]] = 0.0;
+  SCIP_CALL( SCIPlpiAddCols(lpi_, (int)nvars, obj.data(), lb.data(), ub.data(), nullptr,
+                            0, nullptr, nullptr, nullptr) );
+
+  std::vector<double> lhs, rhs, val;
+  std::vector<int> beg, ind;
+
+  // flow conservation == nsd, only visiting the routes incident to each location
+  const auto& inc = inst_.incidence;
+  for (size_t l=0; l<L_; ++l) for (size_t p=0; p<P_; ++p) {
+    if (flowRow_[inst_.lp(l,p)] < 0) continue;
+    const int nsd = inst_.netSupplyDemand[inst_.lp(l,p)];
+    beg.push_back((int)ind.size()); lhs.push_back(nsd); rhs.push_back(nsd);
+    for (size_t k=inc.outStart[l]; k<inc.outStart[l+1]; ++k) {
+      const int f = pairIndex_[inst_.rp(inc.outRoutes[k],p)];
+      if (f >= 0) { ind.push_back(f); val.push_back( 1.0); }
+    }
+    for (size_t k=inc.inStart[l]; k<inc.inStart[l+1]; ++k) {
+      const int f = pairIndex_[inst_.rp(inc.inRoutes[k],p)];
+      if (f >= 0) { ind.push_back(f); val.push_back(-1.0); }
+    }
+  }
+
+  // cover constraints: y - f (+ packings) >= 0
+  for (size_t k=0; k<K; ++k) {
+    beg.push_back((int)ind.size()); lhs.push_back(0.0); rhs.push_back(inf);
+    if (bigM) { ind.push_back((int)(K+k)); val.push_back( 1.0); }
+    ind.push_back((int)k); val.push_back(-1.0);
+  }
+
+  SCIP_CALL( SCIPlpiAddRows(lpi_, (int)lhs.size(), lhs.data(), rhs.data(), nullptr,
+                            (int)ind.size(), beg.data(), ind.data(), val.data()) );
+
+  // cap columns: +1 in cover(r,p), fixed to 0 until caps are set; at cost c they bound the dual by c
+  dualCaps_ = dualCaps;
+  firstCap_ = nvars;
+  firstPacking_ = firstCap_ + (dualCaps ? K : 0);
+  if (dualCaps) {
+    std::vector<double> zero(K, 0.0), one(K, 1.0);
+    std::vector<int> cbeg(K), cind(K);
+    for (size_t k=0; k<K; ++k) { cbeg[k] = (int)k; cind[k] = (int)(flowRows_+k); }
+    SCIP_CALL( SCIPlpiAddCols(lpi_, (int)K, zero.data(), zero.data(), zero.data(), nullptr,
+                              (int)K, cbeg.data(), cind.data(), one.data()) );
+  }
+  return SCIP_OKAY;
+}
+
+SCIP_RETCODE RmpSession::add_column(const Packing& packing, int* id)
+{
+  // a pruned pair has no cover row, the units packed for it carry nothing
+  std::vector<int> ind; std::vector<double> val;
+  for (auto& item: packing.items) {
+    const int k = pairIndex_[inst_.rp(packing.route, std::get<0>(item))];
+    if (k < 0) continue;
+    ind.push_back((int)flowRows_ + k);
+    val.push_back(std::get<1>(item));
+  }
+
+  // on a disabled route or transport resource at upper bound 0, as Replanner leaves its columns
+  const double lb = 0.0, ub = inst_.enabled(packing.route, packing.transportResource) ? SCIPlpiInfinity(lpi_) : 0.0;
+  const int beg = 0;
+  SCIP_CALL( SCIPlpiAddCols(lpi_, 1, &packing.cost, &lb, &ub, nullptr,
+                            (int)ind.size(), &beg, ind.data(), val.data()) );
+
+  const int newId = (int)colOfId_.size();
+  colOfId_.push_back((int)(firstPacking_ + idOfCol_.size()));
+  idOfCol_.push_back(newId);
+  columns_[newId] = packing;
+  columnsChanged_ = true;
+  if (id) *id = newId;
+  return SCIP_OKAY;
+}
+
+SCIP_RETCODE RmpSession::remove_columns(const std::vector<int>& ids)
+{
+  const size_t first = firstPacking_;
+  std::vector<int> dstat(first + idOfCol_.size(), 0);
+  for (int id: ids) {
+    if (id<0 || id>=(int)colOfId_.size() || colOfId_[id]<0) return SCIP_INVALIDDATA;
+    dstat[colOfId_[id]] = 1;
   }
+  SCIP_CALL( SCIPlpiDelColset(lpi_, dstat.data()) );
+
+  // dstat now holds the new position of every column, -1 for deleted ones
+  std::vector<int> idOfCol;
+  for (size_t c=0; c<idOfCol_.size(); ++c) {
+    const int id = idOfCol_[c];
+    colOfId_[id] = dstat[first+c];
+    if (colOfId_[id]<0) columns_.erase(id); else idOfCol.push_back(id);
+  }
+  idOfCol_.swap(idOfCol);
+  primal_.clear();  // column positions moved, the stored solution is stale
+  return SCIP_OKAY;
+}
 
-  // flow conservation == nsd
-  std::map<std::pair<Location*,Product*>, SCIP_CONS*> flow_con;
-  for (auto* loc: locations) for (auto* prod: products) {
-    const int nsd = prod->netSupplyDemand.at(loc);
-    SCIP_CONS* c=nullptr;
-    SCIP_CALL(SCIPcreateConsBasicLinear(scip,&c,"flow",0,nullptr,nullptr, nsd, nsd));
-    SCIP_CALL(SCIPaddCons(scip,c));
-    for (auto* r: routes) {
-      if (r->from==loc) SCIP_CALL(SCIPaddCoefLinear(scip,c,fvar[{r,prod}], 1.0));
-      else if (r->to==loc) SCIP_CALL(SCIPaddCoefLinear(scip,c,fvar[{r,prod}],-1.0));
+SCIP_RETCODE RmpSession::solve()
+{
+  // new columns enter at their lower bound, so the previous basis stays primal feasible;
+  // changed sides and bounds keep it dual feasible instead
+  if (sidesChanged_ && !columnsChanged_) SCIP_CALL( SCIPlpiSolveDual(lpi_) );
+  else SCIP_CALL( SCIPlpiSolvePrimal(lpi_) );
+  sidesChanged_ = columnsChanged_ = false;
+  SCIP_CALL( SCIPlpiGetIterations(lpi_, &lpiters_) );
+
+  optimal_ = SCIPlpiIsOptimal(lpi_);
+  infeasible_ = false;
+  if (!optimal_) {
+    primal_.clear();
+    if (!SCIPlpiIsPrimalInfeasible(lpi_)) return SCIP_OKAY;
+    // primal simplex does not always leave a proof, the dual simplex does
+    if (!SCIPlpiHasDualRay(lpi_)) {
+      int iters = 0;
+      SCIP_CALL( SCIPlpiSolveDual(lpi_) );
+      SCIP_CALL( SCIPlpiGetIterations(lpi_, &iters) );
+      lpiters_ += iters;
+      if (!SCIPlpiHasDualRay(lpi_)) return SCIP_OKAY;
     }
-    flow_con[{loc,prod}] = c;
+    int nrows = 0;
+    SCIP_CALL( SCIPlpiGetNRows(lpi_, &nrows) );
+    rowDuals_.resize(nrows);
+    SCIP_CALL( SCIPlpiGetDualfarkas(lpi_, rowDuals_.data()) );
+    scatter_rows(rowDuals_, farkas_);
+    infeasible_ = true;
+    return SCIP_OKAY;
+  }
+
+  int ncols=0, nrows=0;
+  SCIP_CALL( SCIPlpiGetNCols(lpi_, &ncols) );
+  SCIP_CALL( SCIPlpiGetNRows(lpi_, &nrows) );
+  primal_.resize(ncols); rowDuals_.resize(nrows);
+  SCIP_CALL( SCIPlpiGetSol(lpi_, &objval_, primal_.data(), rowDuals_.data(), nullptr, nullptr) );
+
+  scatter_rows(rowDuals_, duals_);
+  return SCIP_OKAY;
+}
+
+void RmpSession::scatter_rows(const std::vector<double>& rows, std::vector<double>& dense) const
+{
+  std::fill(dense.begin(), dense.end(), 0.0);
+  for (size_t i=0; i<L_*P_; ++i) if (flowRow_[i] >= 0) dense[i] = rows[flowRow_[i]];
+  for (size_t i=0; i<R_*P_; ++i) if (pairIndex_[i] >= 0) dense[L_*P_+i] = rows[flowRows_+pairIndex_[i]];
+}
+
+SCIP_RETCODE RmpSession::set_column_lower_bound(int id, double lb)
+{
+  if (id<0 || id>=(int)colOfId_.size() || colOfId_[id]<0) return SCIP_INVALIDDATA;
+  const int col = colOfId_[id];
+  double oldLb, ub;
+  SCIP_CALL( SCIPlpiGetBounds(lpi_, col, col, &oldLb, &ub) );
+  SCIP_CALL( SCIPlpiChgBounds(lpi_, 1, &col, &lb, &ub) );
+  sidesChanged_ = true;
+  return SCIP_OKAY;
+}
+
+SCIP_RETCODE RmpSession::set_column_upper_bound(int id, double ub)
+{
+  if (id<0 || id>=(int)colOfId_.size() || colOfId_[id]<0) return SCIP_INVALIDDATA;
+  const int col = colOfId_[id];
+  double lb;
+  SCIP_CALL( SCIPlpiGetBounds(lpi_, col, col, &lb, nullptr) );
+  SCIP_CALL( SCIPlpiChgBounds(lpi_, 1, &col, &lb, &ub) );
+  sidesChanged_ = true;
+  return SCIP_OKAY;
+}
+
+SCIP_RETCODE RmpSession::set_column_cost(int id, double cost)
+{
+  if (id<0 || id>=(int)colOfId_.size() || colOfId_[id]<0) return SCIP_INVALIDDATA;
+  const int col = colOfId_[id];
+  SCIP_CALL( SCIPlpiChgObj(lpi_, 1, &col, &cost) );
+  columns_[id].cost = cost;
+  columnsChanged_ = true;
+  return SCIP_OKAY;
+}
+
+SCIP_RETCODE RmpSession::set_flow_upper_bound(size_t route, size_t prod, double ub)
+{
+  const int col = pairIndex_[inst_.rp(route,prod)];
+  if (col < 0) return SCIP_OKAY;
+  const double lb = 0.0;
+  SCIP_CALL( SCIPlpiChgBounds(lpi_, 1, &col, &lb, &ub) );
+  sidesChanged_ = true;
+  return SCIP_OKAY;
+}
+
+SCIP_RETCODE RmpSession::set_flow_rhs(size_t loc, size_t prod, double value)
+{
+  const int row = flowRow_[inst_.lp(loc,prod)];
+  if (row < 0) return value == 0.0 ? SCIP_OKAY : SCIP_INVALIDDATA;
+  SCIP_CALL( SCIPlpiChgSides(lpi_, 1, &row, &value, &value) );
+  sidesChanged_ = true;
+  return SCIP_OKAY;
+}
+
+double RmpSession::infinity() const { return SCIPlpiInfinity(lpi_); }
+
+SCIP_RETCODE RmpSession::get_basis(RmpBasis& basis) const
+{
+  int ncols=0, nrows=0;
+  SCIP_CALL( SCIPlpiGetNCols(lpi_, &ncols) );
+  SCIP_CALL( SCIPlpiGetNRows(lpi_, &nrows) );
+  std::vector<int> cstat(ncols), rstat(nrows);
+  SCIP_CALL( SCIPlpiGetBase(lpi_, cstat.data(), rstat.data()) );
+
+  const size_t RP = R_*P_, LP = L_*P_;
+  basis.f.assign(RP, SCIP_BASESTAT_LOWER);
+  basis.y.assign(RP, SCIP_BASESTAT_LOWER);
+  basis.caps.assign(dualCaps_ ? RP : 0, SCIP_BASESTAT_LOWER);
+  basis.flow.assign(LP, SCIP_BASESTAT_BASIC);
+  basis.cover.assign(RP, SCIP_BASESTAT_BASIC);
+  basis.columns.clear();
+  for (size_t i=0; i<RP; ++i) {
+    const int k = pairIndex_[i];
+    if (k < 0) continue;
+    basis.f[i] = cstat[k];
+    if (bigM_) basis.y[i] = cstat[pairs_+k];
+    if (dualCaps_) basis.caps[i] = cstat[firstCap_+k];
+    basis.cover[i] = rstat[flowRows_+k];
   }
+  for (size_t i=0; i<LP; ++i) if (flowRow_[i] >= 0) basis.flow[i] = rstat[flowRow_[i]];
+  for (size_t c=0; c<idOfCol_.size(); ++c) basis.columns[idOfCol_[c]] = cstat[firstPacking_+c];
+  return SCIP_OKAY;
+}
 
-  // cover constraints: y - f >= 0  (no columns yet)
-  std::map<std::tuple<Route*,Product*>, SCIP_CONS*> cover_con;
-  for (auto* r: routes) for (auto* p: products) {
-    // Big-M y var
-    SCIP_VAR* y=nullptr; char ynm[255];
-    (void)SCIPsnprintf(ynm,255,"y_%s->%s_%s",
-      r->from->name.c_str(), r->to->name.c_str(), p->name.c_str());
-    SCIP_CALL(SCIPcreateVarBasic(scip,&y,ynm,0.0,SCIPinfinity(scip),1e6,SCIP_VARTYPE_CONTINUOUS));
-    SCIP_CALL(SCIPaddVar(scip,y));
-
-    SCIP_CONS* c=nullptr; char cnm[255];
-    (void)SCIPsnprintf(cnm,255,"cover_%s->%s_%s",
-      r->from->name.c_str(), r->to->name.c_str(), p->name.c_str());
-    SCIP_CALL(SCIPcreateConsBasicLinear(scip,&c,cnm,0,nullptr,nullptr, 0.0, SCIPinfinity(scip)));
-    SCIP_CALL(SCIPaddCons(scip,c));
-    SCIP_CALL(SCIPaddCoefLinear(scip,c,y,  1.0));
-    SCIP_CALL(SCIPaddCoefLinear(scip,c,fvar[{r,p}], -1.0));
-    cover_con[{r,p}] = c;
+SCIP_RETCODE RmpSession::set_basis(const RmpBasis& basis)
+{
+  const int ncols = (int)(firstPacking_ + idOfCol_.size()), nrows = (int)(flowRows_ + pairs_);
+  std::vector<int> cstat(ncols, SCIP_BASESTAT_LOWER), rstat(nrows, SCIP_BASESTAT_BASIC);
+  auto entry = [](const std::vector<int>& v, size_t i, int dflt) { return i < v.size() ? v[i] : dflt; };
+  for (size_t i=0; i<R_*P_; ++i) {
+    const int k = pairIndex_[i];
+    if (k < 0) continue;
+    cstat[k] = entry(basis.f, i, SCIP_BASESTAT_LOWER);
+    if (bigM_) cstat[pairs_+k] = entry(basis.y, i, SCIP_BASESTAT_LOWER);
+    if (dualCaps_) cstat[firstCap_+k] = entry(basis.caps, i, SCIP_BASESTAT_LOWER);
+    rstat[flowRows_+k] = entry(basis.cover, i, SCIP_BASESTAT_BASIC);
   }
+  for (size_t i=0; i<L_*P_; ++i) if (flowRow_[i] >= 0) rstat[flowRow_[i]] = entry(basis.flow, i, SCIP_BASESTAT_BASIC);
+  for (const auto& [id, stat]: basis.columns)
+    if (id >= 0 && id < (int)colOfId_.size() && colOfId_[id] >= 0) cstat[colOfId_[id]] = stat;
 
-  SCIP_CALL(SCIPsolve(scip));
+  // a basis has exactly one basic entry per row: add slacks, then drop the newest columns
+  int basic = 0;
+  for (int stat: cstat) basic += stat == SCIP_BASESTAT_BASIC;
+  for (int stat: rstat) basic += stat == SCIP_BASESTAT_BASIC;
+  for (int r=nrows-1; r>=0 && basic<nrows; --r)
+    if (rstat[r] != SCIP_BASESTAT_BASIC) { rstat[r] = SCIP_BASESTAT_BASIC; ++basic; }
+  for (int c=ncols-1; c>=0 && basic>nrows; --c)
+    if (cstat[c] == SCIP_BASESTAT_BASIC) { cstat[c] = SCIP_BASESTAT_LOWER; --basic; }
 
-  // Print duals (so the controller can capture them)
-  std::cout << "\nDUALS_FLOW_BEGIN\n";
-  for (auto& kv: flow_con) {
-    auto* loc = kv.first.first;
-    auto* pr  = kv.first.second;
-    SCIP_Real dual = SCIPgetDualsolLinear(scip, kv.second);
-    std::cout << "phi(" << loc->name << "," << pr->name << ")=" << dual << "\n";
+  SCIP_CALL( SCIPlpiSetBase(lpi_, cstat.data(), rstat.data()) );
+  return SCIP_OKAY;
+}
+
+SCIP_RETCODE RmpSession::set_cover_dual_caps(const std::vector<double>& caps)
+{
+  if (!dualCaps_ || caps.size()!=R_*P_) return SCIP_INVALIDDATA;
+  const size_t K = pairs_;
+  std::vector<int> ind(K);
+  std::vector<double> obj(K), lb(K, 0.0), ub(K, SCIPlpiInfinity(lpi_));
+  for (size_t i=0; i<R_*P_; ++i) {
+    const int k = pairIndex_[i];
+    if (k < 0) continue;
+    ind[k] = (int)(firstCap_+k);
+    obj[k] = caps[i];
   }
-  std::cout << "DUALS_FLOW_END\n";
+  SCIP_CALL( SCIPlpiChgObj(lpi_, (int)K, ind.data(), obj.data()) );
+  SCIP_CALL( SCIPlpiChgBounds(lpi_, (int)K, ind.data(), lb.data(), ub.data()) );
+  return SCIP_OKAY;
+}
 
-  std::cout << "DUALS_COVER_BEGIN\n";
-  for (auto& kv: cover_con) {
-    auto* r = std::get<0>(kv.first);
-    auto* p = std::get<1>(kv.first);
-    SCIP_Real dual = SCIPgetDualsolLinear(scip, kv.second);
+SCIP_RETCODE RmpSession::clear_cover_dual_caps()
+{
+  if (!dualCaps_) return SCIP_OKAY;
+  const size_t K = pairs_;
+  std::vector<int> ind(K);
+  std::vector<double> zero(K, 0.0);
+  for (size_t k=0; k<K; ++k) ind[k] = (int)(firstCap_+k);
+  SCIP_CALL( SCIPlpiChgBounds(lpi_, (int)K, ind.data(), zero.data(), zero.data()) );
+  return SCIP_OKAY;
+}
+
+bool RmpSession::cover_dual_caps_active(double tol) const
+{
+  if (!dualCaps_ || primal_.empty()) return false;
+  const size_t K = pairs_;
+  for (size_t k=0; k<K; ++k) if (primal_[firstCap_+k] > tol) return true;
+  return false;
+}
+
+double RmpSession::pair_value(size_t first, size_t route, size_t prod) const
+{
+  const int k = pairIndex_.empty() ? -1 : pairIndex_[inst_.rp(route,prod)];
+  return (k < 0 || primal_.empty()) ? 0.0 : primal_[first + k];
+}
+
+void RmpSession::route_cover_duals(size_t route, std::vector<double>& out) const
+{
+  out.assign(duals_.begin() + L_*P_ + route*P_, duals_.begin() + L_*P_ + (route+1)*P_);
+}
+
+double RmpSession::column_value(int id) const
+{
+  if (id<0 || id>=(int)colOfId_.size() || colOfId_[id]<0) return 0.0;
+  const int col = colOfId_[id];
+  return col<(int)primal_.size() ? primal_[col] : 0.0;
+}
+
+void RmpSession::print_duals(std::ostream& os) const
+{
+  os << "\nDUALS_FLOW_BEGIN\n";
+  for (size_t l=0; l<L_; ++l) for (size_t p=0; p<P_; ++p)
+    os << "phi(" << inst_.locations[l]->name << "," << inst_.products[p]->name << ")=" << flow_dual(l,p) << "\n";
+  os << "DUALS_FLOW_END\n";
+
+  os << "DUALS_COVER_BEGIN\n";
+  for (size_t r=0; r<R_; ++r) for (size_t p=0; p<P_; ++p) {
     // Label route by endpoints (and you can extend with TR if you split routes by TR)
-    std::cout << "dualCover(" << r->from->name << "->" << r->to->name << "," << p->name << ")=" << dual << "\n";
+    os << "dualCover(" << inst_.routes[r]->from->name << "->" << inst_.routes[r]->to->name << ","
+       << inst_.products[p]->name << ")=" << cover_dual(r,p) << "\n";
   }
-  std::cout << "DUALS_COVER_END\n";
-
-  // cleanup
-  for (auto& kv: cover_con) SCIP_CALL(SCIPreleaseCons(scip,&kv.second));
-  for (auto& kv: flow_con)  SCIP_CALL(SCIPreleaseCons(scip,&kv.second));
-  for (auto& kv: fvar)      SCIP_CALL(SCIPreleaseVar(scip,&kv.second));
-  SCIP_CALL(SCIPfree(&scip));
-  BMScheckEmptyMemory();
+  os << "DUALS_COVER_END\n";
+}
+
+SCIP_RETCODE solve_rmp_from_data(const Instance& instance)
+{
+  RmpSession session(instance);
+  SCIP_CALL( session.init() );
+  SCIP_CALL( session.solve() );
+  if (!session.optimal()) {
+    std::cerr << "RMP not solved to optimality\n";
+    return SCIP_ERROR;
+  }
+
+  // Print duals (so the controller can capture them)
+  session.print_duals(std::cout);
   return SCIP_OKAY;
 }
@@ -2,12 +2,134 @@
 #include <vector>
 #include <map>
 #include <tuple>
-#include "main.h"  // where Settings, Location, TransportResource, Product, Route are declared
+#include <ostream>
+#include "instance.h"  // dense view over Settings, Location, TransportResource, Product, Route
+#include "packing.h"
 #include "objscip/objscip.h"
+#include "lpi/lpi.h"
 
-scip::SCIP_RETCODE solve_rmp_from_data(
-    const Settings& settings,
-    const std::vector<Location*>& locations,
-    const std::vector<TransportResource*>& transportResources,
-    const std::vector<Product*>& products,
-    const std::vector<Route*>& routes);
+scip::SCIP_RETCODE solve_rmp_from_data(const Instance& instance);
+
+// LP basis of a session by dense id, statuses are SCIP_BASESTAT_*: f, y and caps at rp, flow rows
+// at lp, cover rows at rp, packing columns by id. Entries for pruned pairs and rows, and for
+// columns a session does not have, are ignored.
+struct RmpBasis {
+  std::vector<int> f, y, caps, flow, cover;
+  std::map<int, int> columns;
+};
+
+// Long-lived RMP kept as a plain LP between solves. Columns are appended to the
+// LP in place, so every re-solve starts primal simplex from the previous basis
+// instead of rebuilding and cold-solving the whole model.
+//
+// LP layout: columns [f(r,p) | y(r,p) | caps(r,p) | packings...], rows [flow(l,p) | cover(r,p)],
+// in dense id order but only for the pairs and flow rows the instance keeps active (presolve.h);
+// the y and cap columns only exist if requested in init. Everything outside the session (duals,
+// caps, values) uses the full dense layout, pruned entries read 0.
+// The instance must outlive the session.
+class RmpSession {
+public:
+  explicit RmpSession(const Instance& instance);
+  ~RmpSession();
+
+  RmpSession(const RmpSession&) = delete;
+  RmpSession& operator=(const RmpSession&) = delete;
+
+  // builds the initial LP (f, Big-M y, flow and cover rows); call once before anything else.
+  // dualCaps adds one surplus column per cover row, used to box the cover duals (box-step).
+  // Without bigM there are no y columns: the LP stays infeasible until packings cover the
+  // flow, and each infeasible solve leaves a Farkas proof to price on instead of duals
+  scip::SCIP_RETCODE init(bool dualCaps = false, bool bigM = true);
+
+  // appends a packing column; its id stays valid until it is removed
+  scip::SCIP_RETCODE add_column(const Packing& packing, int* id = nullptr);
+  // drops packing columns by id, e.g. ones that stayed nonbasic for a while
+  scip::SCIP_RETCODE remove_columns(const std::vector<int>& ids);
+  // re-optimizes from the current basis
+  scip::SCIP_RETCODE solve();
+
+  // forces a packing column to at least lb (diving); 0 releases it
+  scip::SCIP_RETCODE set_column_lower_bound(int id, double lb);
+
+  // in-place changes for replanning (replan.h); the next solve starts from the current basis,
+  // with the dual simplex if only right-hand sides and bounds changed since the last one
+  scip::SCIP_RETCODE set_column_upper_bound(int id, double ub);   // infinity() releases it
+  scip::SCIP_RETCODE set_column_cost(int id, double cost);
+  // upper bound of f(r,p), 0 closes the pair; pruned pairs are ignored
+  scip::SCIP_RETCODE set_flow_upper_bound(size_t route, size_t prod, double ub);
+  // both sides of the flow row of (l,p); SCIP_INVALIDDATA for a nonzero value on a pruned row
+  scip::SCIP_RETCODE set_flow_rhs(size_t loc, size_t prod, double value);
+  double infinity() const;
+
+  // basis of the last solve, and a basis to start the next one from (e.g. a snapshot of an
+  // earlier run); missing entries default to nonbasic columns and basic rows, and the number of
+  // basic entries is repaired with row slacks or by dropping columns from the basis
+  scip::SCIP_RETCODE get_basis(RmpBasis& basis) const;
+  scip::SCIP_RETCODE set_basis(const RmpBasis& basis);
+
+  // box-step: the cover dual of (r,p) cannot exceed caps[rp] while set (needs init(true))
+  scip::SCIP_RETCODE set_cover_dual_caps(const std::vector<double>& caps);
+  scip::SCIP_RETCODE clear_cover_dual_caps();
+  // true if the last solution uses a cap column, i.e. some cap is binding
+  bool cover_dual_caps_active(double tol = 1e-9) const;
+
+  bool   optimal()    const { return optimal_; }
+  // the last solve proved the LP infeasible, farkas() holds the proof
+  bool   infeasible() const { return infeasible_; }
+  double objective()  const { return objval_; }
+  int    iterations() const { return lpiters_; }   // simplex pivots of the last solve
+
+  double flow_dual(size_t loc, size_t prod)    const { return duals_[inst_.lp(loc,prod)]; }
+  double cover_dual(size_t route, size_t prod) const { return duals_[L_*P_ + inst_.rp(route,prod)]; }
+  // all duals, [flow(l,p) | cover(r,p)] over all dense ids, 0 for rows presolve removed; the
+  // storage is allocated by init and overwritten by every solve, views of it stay valid
+  const std::vector<double>& duals() const { return duals_; }
+  // cover duals at instance().rp(r,p), the input of price_routes
+  const double* cover_duals() const { return duals_.data() + L_*P_; }
+  // Farkas multipliers of the last infeasible solve, same layout as duals(); a packing destroys
+  // the proof iff it covers sum units * cover_farkas()[rp] > 0, price_routes(farkas=true) finds those
+  const std::vector<double>& farkas() const { return farkas_; }
+  const double* cover_farkas() const { return farkas_.data() + L_*P_; }
+  // cover duals of one route, indexed by product id (input for price_packing)
+  void   route_cover_duals(size_t route, std::vector<double>& out) const;
+
+  double flow_value(size_t route, size_t prod)  const { return pair_value(0, route, prod); }
+  double big_m_value(size_t route, size_t prod) const { return bigM_ ? pair_value(pairs_, route, prod) : 0.0; }
+  double column_value(int id) const;
+  const std::map<int, Packing>& columns() const { return columns_; }
+
+  void print_duals(std::ostream& os) const;
+
+  const Instance& instance() const { return inst_; }
+
+private:
+  // value of the column of (r,p) in the block starting at LP column first
+  double pair_value(size_t first, size_t route, size_t prod) const;
+  // row values in LP order -> dense [flow(l,p) | cover(r,p)] as sized by init, 0 for pruned rows
+  void scatter_rows(const std::vector<double>& rows, std::vector<double>& dense) const;
+
+  const Instance& inst_;
+  size_t L_ = 0, P_ = 0, R_ = 0;
+  size_t pairs_ = 0;                 // active (r,p), columns per block and cover rows
+  size_t flowRows_ = 0;              // active (l,p), the cover rows follow them
+  std::vector<int> pairIndex_;       // rp -> position among the active pairs, -1 if pruned
+  std::vector<int> flowRow_;         // lp -> LP row, -1 if pruned
+  std::vector<double> rowDuals_;     // duals in LP row order
+
+  SCIP_LPI* lpi_ = nullptr;
+  bool dualCaps_ = false;
+  bool bigM_ = true;
+  size_t firstCap_ = 0;              // LP column of the first cap
+  size_t firstPacking_ = 0;          // LP column of the first packing
+  std::map<int, Packing> columns_;   // packing id -> packing
+  std::vector<int> colOfId_;         // packing id -> LP column (-1 once removed)
+  std::vector<int> idOfCol_;         // LP column - firstPacking_ -> packing id
+
+  bool optimal_ = false;
+  bool infeasible_ = false;
+  bool sidesChanged_ = false;        // rhs or bounds changed since the last solve
+  bool columnsChanged_ = false;      // columns or costs changed since the last solve
+  double objval_ = 0.0;
+  int lpiters_ = 0;
+  std::vector<double> primal_, duals_, farkas_;
+};
@@ -0,0 +1,203 @@
+#include "snapshot.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+using namespace scip;
+
+namespace {
+
+const double SIZE_EPS = 1e-9;  // same rounding as price_packing
+
+struct Fnv {
+  std::uint64_t h = 1469598103934665603ull;
+  void bytes(const void* data, size_t n) {
+    const unsigned char* c = static_cast<const unsigned char*>(data);
+    for (size_t i=0; i<n; ++i) { h ^= c[i]; h *= 1099511628211ull; }
+  }
+  template<class T> void value(const T& v) { bytes(&v, sizeof v); }
+  template<class T> void values(const std::vector<T>& v) { value(v.size()); bytes(v.data(), v.size()*sizeof(T)); }
+  void name(const pmr::string& s) { value(s.size()); bytes(s.data(), s.size()); }
+};
+
+// routes by end locations; n is the position among the routes with the same ends
+std::string route_key(const Instance& inst, size_t r, int n)
+{
+  return escape_name(inst.locations[inst.routeFrom[r]]->name) + ' '
+         + escape_name(inst.locations[inst.routeTo[r]]->name) + ' ' + std::to_string(n);
+}
+
+bool valid_status(int stat)
+{
+  return stat == SCIP_BASESTAT_LOWER || stat == SCIP_BASESTAT_BASIC || stat == SCIP_BASESTAT_UPPER
+         || stat == SCIP_BASESTAT_ZERO;
+}
+
+std::vector<int> parallel_position(const Instance& inst)
+{
+  std::map<std::pair<int,int>, int> seen;
+  std::vector<int> n(inst.R);
+  for (size_t r=0; r<inst.R; ++r) n[r] = seen[{inst.routeFrom[r], inst.routeTo[r]}]++;
+  return n;
+}
+
+template<class Objects>
+std::unordered_map<std::string, int> ids_by_name(const Objects& objects)
+{
+  std::unordered_map<std::string, int> ids;
+  for (const auto* o: objects) ids.emplace(escape_name(o->name), o->id);
+  return ids;
+}
+
+int find(const std::unordered_map<std::string, int>& ids, const std::string& key)
+{
+  auto it = ids.find(key);
+  return it == ids.end() ? -1 : it->second;
+}
+
+// the slot of the transport resource on route r, -1 if the route has none
+int slot_of(const Instance& inst, int r, int tr)
+{
+  for (size_t k=inst.routeTRStart[r]; k<inst.routeTRStart[r+1]; ++k) if (inst.routeTR[k] == tr) return (int)k;
+  return -1;
+}
+
+} // namespace
+
+std::uint64_t instance_fingerprint(const Instance& inst)
+{
+  Fnv fnv;
+  fnv.value(inst.settings.co2Costs); fnv.value(inst.settings.capitalCosts);
+  fnv.value(inst.L); fnv.value(inst.T); fnv.value(inst.P); fnv.value(inst.R);
+  for (const auto* l: inst.locations) fnv.name(l->name);
+  for (const auto* t: inst.transportResources) fnv.name(t->name);
+  for (const auto* p: inst.products) fnv.name(p->name);
+  fnv.values(inst.trCapacity); fnv.values(inst.trCo2Emissions); fnv.values(inst.trCost); fnv.values(inst.trSpeed);
+  fnv.values(inst.productSize); fnv.values(inst.productValue); fnv.values(inst.validTR); fnv.values(inst.netSupplyDemand);
+  fnv.values(inst.routeFrom); fnv.values(inst.routeTo); fnv.values(inst.routeTRStart); fnv.values(inst.routeTR);
+  fnv.values(inst.routeDistance);
+  fnv.values(inst.pairActive); fnv.values(inst.flowActive); fnv.values(inst.routeEnabled); fnv.values(inst.trEnabled);
+  return fnv.h;
+}
+
+SCIP_RETCODE save_snapshot(const RmpSession& session, const std::string& path)
+{
+  const Instance& inst = session.instance();
+  RmpBasis basis;
+  SCIP_CALL( session.get_basis(basis) );
+
+  std::ofstream out(path);
+  if (!out) return SCIP_WRITEERROR;
+  const std::vector<int> parallel = parallel_position(inst);
+  char hex[17];
+  snprintf(hex, sizeof hex, "%016llx", (unsigned long long)instance_fingerprint(inst));
+  out << "LNO-SNAPSHOT 1\nfingerprint " << hex << "\n";
+
+  for (const auto& [id, packing]: session.columns()) {
+    auto stat = basis.columns.find(id);
+    out << "column " << route_key(inst, packing.route, parallel[packing.route]) << ' '
+        << escape_name(inst.transportResources[packing.transportResource]->name) << ' '
+        << (stat == basis.columns.end() ? (int)SCIP_BASESTAT_LOWER : stat->second);
+    for (const auto& [p, units]: packing.items) out << ' ' << escape_name(inst.products[p]->name) << '=' << units;
+    out << '\n';
+  }
+  auto at = [](const std::vector<int>& v, size_t i) { return i < v.size() ? v[i] : (int)SCIP_BASESTAT_LOWER; };
+  for (size_t r=0; r<inst.R; ++r) for (size_t p=0; p<inst.P; ++p) {
+    if (!inst.active(r,p)) continue;
+    const size_t i = inst.rp(r,p);
+    const int f = at(basis.f, i), y = at(basis.y, i), cap = at(basis.caps, i), cover = basis.cover[i];
+    if (f == SCIP_BASESTAT_LOWER && y == SCIP_BASESTAT_LOWER && cap == SCIP_BASESTAT_LOWER && cover == SCIP_BASESTAT_BASIC)
+      continue;
+    out << "pair " << route_key(inst, r, parallel[r]) << ' ' << escape_name(inst.products[p]->name) << ' '
+        << f << ' ' << y << ' ' << cap << ' ' << cover << '\n';
+  }
+  for (size_t l=0; l<inst.L; ++l) for (size_t p=0; p<inst.P; ++p) {
+    if (!inst.flow_active(l,p) || basis.flow[inst.lp(l,p)] == SCIP_BASESTAT_BASIC) continue;
+    out << "flow " << escape_name(inst.locations[l]->name) << ' ' << escape_name(inst.products[p]->name) << ' ' << basis.flow[inst.lp(l,p)] << '\n';
+  }
+  return out ? SCIP_OKAY : SCIP_WRITEERROR;
+}
+
+SCIP_RETCODE load_snapshot(RmpSession& session, const std::string& path, SnapshotLoad& load)
+{
+  load = SnapshotLoad();
+  std::ifstream in(path);
+  std::string line, word;
+  if (!in || !std::getline(in, line) || line != "LNO-SNAPSHOT 1") return SCIP_OKAY;
+  load.found = true;
+
+  const Instance& inst = session.instance();
+  const auto locations = ids_by_name(inst.locations);
+  const auto products = ids_by_name(inst.products);
+  const auto trs = ids_by_name(inst.transportResources);
+  std::unordered_map<std::string, int> routes;
+  const std::vector<int> parallel = parallel_position(inst);
+  for (size_t r=0; r<inst.R; ++r) routes.emplace(route_key(inst, r, parallel[r]), (int)r);
+
+  RmpBasis basis;
+  basis.f.assign(inst.R*inst.P, SCIP_BASESTAT_LOWER);
+  basis.y = basis.f; basis.caps = basis.f;
+  basis.cover.assign(inst.R*inst.P, SCIP_BASESTAT_BASIC);
+  basis.flow.assign(inst.L*inst.P, SCIP_BASESTAT_BASIC);
+
+  char hex[17];
+  snprintf(hex, sizeof hex, "%016llx", (unsigned long long)instance_fingerprint(inst));
+  while (std::getline(in, line)) {
+    std::istringstream fields(line);
+    std::string kind, from, to;
+    int n = 0;
+    if (!(fields >> kind)) continue;
+    if (kind == "fingerprint") { fields >> word; load.exact = word == hex; continue; }
+    if (kind == "flow") {
+      std::string location, product; int stat = 0;
+      const bool read = (bool)(fields >> location >> product >> stat);
+      const int l = find(locations, location), p = find(products, product);
+      if (!read || !valid_status(stat) || l < 0 || p < 0 || !inst.flow_active(l,p)) { ++load.statusesSkipped; continue; }
+      basis.flow[inst.lp(l,p)] = stat; ++load.statuses;
+      continue;
+    }
+
+    fields >> from >> to >> n;
+    const int r = find(routes, from + ' ' + to + ' ' + std::to_string(n));
+    if (kind == "pair") {
+      std::string product; int f = 0, y = 0, cap = 0, cover = 0;
+      const bool read = (bool)(fields >> product >> f >> y >> cap >> cover);
+      const int p = find(products, product);
+      if (!read || !valid_status(f) || !valid_status(y) || !valid_status(cap) || !valid_status(cover)
+          || r < 0 || p < 0 || !inst.active(r,p)) { ++load.statusesSkipped; continue; }
+      const size_t i = inst.rp(r,p);
+      basis.f[i] = f; basis.y[i] = y; basis.caps[i] = cap; basis.cover[i] = cover; ++load.statuses;
+    }
+    else if (kind == "column") {
+      std::string trName; int stat = 0;
+      if (!(fields >> trName >> stat)) { ++load.columnsSkipped; continue; }
+      const int tr = find(trs, trName);
+      const int slot = r < 0 || tr < 0 ? -1 : slot_of(inst, r, tr);
+      bool fits = slot >= 0 && inst.enabled(r, tr);
+      Packing packing{r, tr, fits ? inst.routeDistance[slot] : 0.0, {}, 0.0};
+      int used = 0;
+      while (fits && fields >> word) {
+        const size_t eq = word.rfind('=');
+        const int p = eq == std::string::npos ? -1 : find(products, word.substr(0, eq));
+        const int units = eq == std::string::npos ? 0 : atoi(word.c_str() + eq + 1);
+        fits = p >= 0 && units > 0 && inst.active(r,p) && inst.valid(p, tr);
+        if (fits) { packing.items.emplace_back(p, units); used += units*(int)std::ceil(inst.productSize[p] - SIZE_EPS); }
+      }
+      if (!fits || packing.items.empty() || used > (int)std::floor(inst.trCapacity[tr] + SIZE_EPS)) {
+        ++load.columnsSkipped; continue;
+      }
+      packing.cost = packing_cost(inst, tr, packing.distance, packing.items);
+      int id = -1;
+      SCIP_CALL( session.add_column(packing, &id) );
+      ++load.columns;
+      if (valid_status(stat)) { basis.columns[id] = stat; ++load.statuses; }
+      else ++load.statusesSkipped;
+    }
+  }
+  SCIP_CALL( session.set_basis(basis) );
+  return SCIP_OKAY;
+}
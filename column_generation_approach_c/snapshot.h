@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include "rmp_core.h"
+
+// Warm start across runs: a snapshot holds the generated packing columns, the final LP basis
+// and a fingerprint of the instance it was taken on. Everything is written by name (locations,
+// products, transport resources; a route by its end locations and its position among the
+// routes between them), so a snapshot can be loaded into a session on a changed instance:
+// columns whose route, transport resource or products are gone, or that no longer fit, are
+// skipped, the others are re-costed, and the basis statuses of what still exists are applied.
+//
+//   LNO-SNAPSHOT 1
+//   fingerprint <16 hex digits>
+//   column <from> <to> <n> <tr> <status> <product>=<units>...
+//   pair <from> <to> <n> <product> <f> <y> <cap> <cover>
+//   flow <location> <product> <status>
+//
+// Names are written with whitespace, '%' and '=' as %XX (escape_name). Statuses are
+// SCIP_BASESTAT_* values, others are skipped on loading; pairs and flow rows at the default
+// status (nonbasic columns, basic rows) are not written.
+
+// FNV-1a over the names and all data of the instance, including what presolve switched off
+std::uint64_t instance_fingerprint(const Instance& instance);
+
+struct SnapshotLoad {
+  bool found = false;          // the file exists and is a snapshot
+  bool exact = false;          // taken on an instance with the same fingerprint
+  size_t columns = 0, columnsSkipped = 0;
+  size_t statuses = 0, statusesSkipped = 0;
+};
+
+// the session's columns and the basis of its last solve
+scip::SCIP_RETCODE save_snapshot(const RmpSession& session, const std::string& path);
+
+// adds the snapshot's columns to an initialized session and sets the basis for its next solve;
+// a missing or unreadable file leaves the session alone with load.found false
+scip::SCIP_RETCODE load_snapshot(RmpSession& session, const std::string& path, SnapshotLoad& load);
@@ -0,0 +1,58 @@
+#include "stats.h"
+#include <cmath>
+#include <nlohmann/json.hpp>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+using json = nlohmann::json;
+
+static json round_json(const Stats::Round& r)
+{
+  // bounds are +-inf before the first one is known, which json cannot hold
+  auto bound = [](double v) { return std::isfinite(v) ? json(v) : json(nullptr); };
+  return json{{"round", r.round}, {"wall", r.wall}, {"cpu", r.cpu},
+              {"primal_bound", bound(r.primalBound)}, {"dual_bound", bound(r.dualBound)},
+              {"lp_iterations", r.lpIterations}, {"columns_added", r.columnsAdded},
+              {"columns_total", r.columnsTotal}, {"pricing_seconds", r.pricingSeconds}};
+}
+
+Stats::Stats() : wall0_(std::chrono::steady_clock::now()), cpu0_(std::clock()) {}
+
+double Stats::wall() const { return std::chrono::duration<double>(std::chrono::steady_clock::now() - wall0_).count(); }
+double Stats::cpu() const { return double(std::clock() - cpu0_) / CLOCKS_PER_SEC; }
+
+void Stats::add_time(const std::string& phase, double wall, double cpu)
+{
+  Phase& p = phases_[phase];
+  p.wall += wall; p.cpu += cpu; ++p.calls;
+}
+
+void Stats::count(const std::string& counter, long n) { counters_[counter] += n; }
+
+void Stats::round(const Round& round)
+{
+  rounds_.push_back(round);
+  if (stream_) *stream_ << round_json(round).dump() << "\n" << std::flush;
+}
+
+void Stats::write_json(std::ostream& os) const
+{
+  json phases = json::object(), counters = json::object(), rounds = json::array();
+  for (const auto& [name, p]: phases_) phases[name] = json{{"wall", p.wall}, {"cpu", p.cpu}, {"calls", p.calls}};
+  for (const auto& [name, n]: counters_) counters[name] = n;
+  for (const auto& r: rounds_) rounds.push_back(round_json(r));
+  os << json{{"wall", wall()}, {"cpu", cpu()}, {"phases", phases}, {"counters", counters}, {"rounds", rounds}}.dump(2) << "\n";
+}
+
+long peak_rss_bytes()
+{
+#if defined(__APPLE__)
+  struct rusage usage;
+  return getrusage(RUSAGE_SELF, &usage) == 0 ? (long)usage.ru_maxrss : 0;  // bytes
+#elif defined(__unix__)
+  struct rusage usage;
+  return getrusage(RUSAGE_SELF, &usage) == 0 ? (long)usage.ru_maxrss * 1024 : 0;  // kilobytes
+#else
+  return 0;
+#endif
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <chrono>
+#include <ctime>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Lightweight solver instrumentation: named phases with wall/CPU time and call counts,
+// named counters and one record per column generation round. Written as one json object
+// at the end, rounds can additionally be streamed as json lines while the solver runs.
+// Not thread safe: only the thread driving the solver records (pricing tasks do not).
+class Stats {
+public:
+  struct Phase { double wall = 0.0, cpu = 0.0; size_t calls = 0; };
+
+  struct Round {
+    size_t round = 0;
+    double wall = 0.0;         // seconds since the Stats object was created
+    double cpu = 0.0;          // process CPU seconds (all threads) since then
+    double primalBound = 0.0;  // RMP objective
+    double dualBound = 0.0;    // best Lagrangian / LP bound known after the round
+    long   lpIterations = 0;   // simplex pivots of this round's solve
+    size_t columnsAdded = 0;
+    size_t columnsTotal = 0;
+    double pricingSeconds = 0.0;
+  };
+
+  Stats();
+
+  void add_time(const std::string& phase, double wall, double cpu);
+  void count(const std::string& counter, long n = 1);
+  void round(const Round& round);
+
+  // every round is also written to os as one json line, e.g. std::cerr
+  void stream_rounds(std::ostream* os) { stream_ = os; }
+
+  double wall() const;
+  double cpu() const;
+  const std::map<std::string, Phase>& phases() const { return phases_; }
+  const std::map<std::string, long>& counters() const { return counters_; }
+  const std::vector<Round>& rounds() const { return rounds_; }
+
+  void write_json(std::ostream& os) const;
+
+private:
+  std::chrono::steady_clock::time_point wall0_;
+  std::clock_t cpu0_;
+  std::map<std::string, Phase> phases_;
+  std::map<std::string, long> counters_;
+  std::vector<Round> rounds_;
+  std::ostream* stream_ = nullptr;
+};
+
+// peak resident set size of the process in bytes, 0 where the platform does not report it
+long peak_rss_bytes();
+
+// adds the wall and CPU time of its scope to a phase; does nothing without a Stats object
+class ScopedTimer {
+public:
+  // without stats neither clock is read
+  ScopedTimer(Stats* stats, const char* phase) : stats_(stats), phase_(phase) {
+    if (!stats_) return;
+    wall0_ = std::chrono::steady_clock::now();
+    cpu0_ = std::clock();
+  }
+  ~ScopedTimer() {
+    if (!stats_) return;
+    stats_->add_time(phase_, std::chrono::duration<double>(std::chrono::steady_clock::now() - wall0_).count(),
+                     double(std::clock() - cpu0_) / CLOCKS_PER_SEC);
+  }
+
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+  Stats* stats_;
+  const char* phase_;
+  std::chrono::steady_clock::time_point wall0_;
+  std::clock_t cpu0_ = 0;
+};
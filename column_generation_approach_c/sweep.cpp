@@ -0,0 +1,151 @@
+#include "sweep.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <numeric>
+#include <sstream>
+#include "greedy_start.h"
+#include "replan.h"
+#include "thread_pool.h"
+using namespace scip;
+
+namespace {
+
+// flow values below this are reported as zero
+const double FLOW_EPS = 1e-9;
+
+// input positions sorted by co2Costs, capitalCosts ascending and descending in turns, so that
+// consecutive scenarios of a grid differ in one rate by one step
+std::vector<size_t> snake_order(const std::vector<Settings>& scenarios)
+{
+  std::vector<size_t> order(scenarios.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    const Settings& x = scenarios[a]; const Settings& y = scenarios[b];
+    return x.co2Costs != y.co2Costs ? x.co2Costs < y.co2Costs : x.capitalCosts < y.capitalCosts;
+  });
+  bool down = false;
+  for (size_t i=0; i<order.size();) {
+    size_t j = i;
+    while (j < order.size() && scenarios[order[j]].co2Costs == scenarios[order[i]].co2Costs) ++j;
+    if (down) std::reverse(order.begin()+i, order.begin()+j);
+    down = !down;
+    i = j;
+  }
+  return order;
+}
+
+// solves the scenarios order[begin, end) one after the other on one session
+bool run_chain(const Instance& instance, const std::vector<Settings>& scenarios, const std::vector<size_t>& order,
+               size_t begin, size_t end, size_t chain, const SweepOptions& options,
+               std::vector<ScenarioResult>& results)
+{
+  // the first scenario's time includes the copy, the build and the greedy seed
+  auto start = std::chrono::steady_clock::now();
+  Instance inst = instance;
+  inst.settings = scenarios[order[begin]];
+  RmpSession session(inst);
+  ColumnGenerationOptions cgOptions = options.options;
+  cgOptions.pricer = nullptr;    // its costs are fixed when it is built
+  cgOptions.stats = nullptr;     // Stats is single threaded
+  cgOptions.stabilization.log = nullptr;
+  if (session.init(cgOptions.stabilization.boxStep, !cgOptions.farkas) != SCIP_OKAY) return false;
+  if (options.greedy) {
+    TransportPlan greedy;
+    greedy_plan(inst, greedy);
+    if (seed_columns(session, greedy) != SCIP_OKAY) return false;
+  }
+  Replanner replanner(inst, session);
+  WorkStealingPool pricingPool(cgOptions.pricing.threads == 0 ? 1 : cgOptions.pricing.threads);
+
+  for (size_t i=begin; i<end; ++i) {
+    if (i > begin) start = std::chrono::steady_clock::now();
+    ScenarioResult& out = results[order[i]];
+    out.settings = scenarios[order[i]];
+    out.chain = chain;
+    out.warm = i > begin;
+    if (out.warm && replanner.set_settings(out.settings) != SCIP_OKAY) return false;
+
+    ColumnGenerationResult result;
+    if (run_column_generation(session, cgOptions, pricingPool, result) != SCIP_OKAY) return false;
+    out.feasible = session.optimal();
+    out.optimal = result.optimal;
+    out.gapClosed = result.gapClosed;
+    out.tailingOff = result.tailingOff;
+    out.objective = result.objective;
+    out.lowerBound = result.lowerBound;
+    out.rounds = result.rounds;
+    out.columns = result.columns;
+    out.lpIterations = result.lpIterations;
+    if (out.feasible)
+      for (size_t r=0; r<inst.R; ++r) for (size_t p=0; p<inst.P; ++p) {
+        if (!inst.active(r, p)) continue;
+        const double value = session.flow_value(r, p);
+        if (value > FLOW_EPS) out.flows.emplace_back((int)r, (int)p, value);
+      }
+    out.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+  return true;
+}
+
+} // namespace
+
+bool read_scenarios(std::istream& in, std::vector<Settings>& scenarios, std::string& error)
+{
+  std::string line;
+  for (size_t lineNo=1; std::getline(in, line); ++lineNo) {
+    line = line.substr(0, line.find('#'));
+    if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+    std::istringstream fields(line);
+    double co2 = 0, capital = 0;
+    std::string rest;
+    if (!(fields >> co2 >> capital) || (fields >> rest)) {
+      error = "line " + std::to_string(lineNo) + ": expected \"<co2Costs> <capitalCosts>\"";
+      return false;
+    }
+    scenarios.emplace_back(co2, capital);
+  }
+  return true;
+}
+
+bool run_sweep(const Instance& instance, const std::vector<Settings>& scenarios, const SweepOptions& options,
+               std::vector<ScenarioResult>& results)
+{
+  results.assign(scenarios.size(), ScenarioResult());
+  if (scenarios.empty()) return true;
+
+  const std::vector<size_t> order = snake_order(scenarios);
+  const size_t chains = std::max<size_t>(1, std::min(options.chains, scenarios.size()));
+  std::atomic<bool> ok(true);
+  WorkStealingPool workers(chains);
+  workers.parallel_for(chains, [&](size_t c) {
+    // chain c gets the c-th of equal contiguous parts of the order
+    const size_t begin = c*scenarios.size()/chains, end = (c+1)*scenarios.size()/chains;
+    if (!run_chain(instance, scenarios, order, begin, end, c, options, results)) ok = false;
+  });
+  return ok;
+}
+
+void write_sweep_report(std::ostream& os, const Instance& instance, const SweepOptions& options,
+                        const std::vector<ScenarioResult>& results)
+{
+  double total = 0.0;
+  for (size_t i=0; i<results.size(); ++i) {
+    const ScenarioResult& s = results[i];
+    total += s.seconds;
+    os << "SCENARIO " << i << " CO2 " << s.settings.co2Costs << " CAPITAL " << s.settings.capitalCosts;
+    if (!s.feasible) os << " INFEASIBLE";
+    else os << " OBJ " << s.objective << " BOUND " << s.lowerBound << " ROUNDS " << s.rounds << " COLUMNS " << s.columns
+            << " ITER " << s.lpIterations << " STATUS "
+            << (s.optimal ? "optimal" : s.gapClosed ? "gap" : s.tailingOff ? "tailing" : "limit");
+    os << " SECONDS " << s.seconds << " CHAIN " << s.chain << " WARM " << (s.warm ? 1 : 0) << "\n";
+    for (const auto& [r, p, value]: s.flows) {
+      const Route* route = instance.routes[r];
+      os << "flow(" << route->from->name << "," << route->to->name << "," << instance.products[p]->name << "," << value
+         << ").\n";
+    }
+    os << "END " << i << "\n";
+  }
+  os << "SWEEP SCENARIOS " << results.size() << " CHAINS " << std::max<size_t>(1, std::min(options.chains, results.size()))
+     << " SECONDS " << total << "\n";
+}
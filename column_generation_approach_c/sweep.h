@@ -0,0 +1,58 @@
+#pragma once
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "column_generation.h"
+
+// Parametric sweep over the cost rates: many Settings on one network, each solved by column
+// generation warm-started from a neighbouring scenario.
+//
+// The scenarios are ordered so that neighbours differ little (by co2Costs, capitalCosts in a
+// snake through the grid) and cut into contiguous chains solved in parallel. A chain builds its
+// RMP once; every further scenario is applied with Replanner::set_settings, which re-costs the
+// columns in place, so column generation restarts from the previous columns and basis.
+struct SweepOptions {
+  size_t chains = 1;        // chains solved concurrently, each with its own copy of the instance and LP
+  bool   greedy = false;    // seed the first RMP of every chain with the greedy_plan packings
+  ColumnGenerationOptions options;  // options.pricer and options.stats are not used
+};
+
+struct ScenarioResult {
+  Settings settings;
+  bool   feasible = false;   // the last RMP was solved to optimality, false if it is infeasible
+  bool   optimal = false;    // pricing found no improving column, ColumnGenerationResult::optimal
+  bool   gapClosed = false;  // stopped early on the gap, see ColumnGenerationResult
+  bool   tailingOff = false; // stopped early on tailing off
+  bool   warm = false;       // started from the previous scenario of its chain
+  size_t chain = 0;
+  double objective = 0.0;
+  double lowerBound = 0.0;
+  size_t rounds = 0;
+  size_t columns = 0;        // added for this scenario
+  long   lpIterations = 0;
+  double seconds = 0.0;      // wall time of this scenario, settings update (or, for the first
+                             // scenario of a chain, the RMP build and greedy seed) included
+  std::vector<std::tuple<int,int,double>> flows;  // (route, product, value) of the nonzero flows
+};
+
+// Reads one scenario per non-empty line, "<co2Costs> <capitalCosts>", '#' starts a comment.
+// Returns false with a message on a malformed line.
+bool read_scenarios(std::istream& in, std::vector<Settings>& scenarios, std::string& error);
+
+// Solves every scenario on the instance (which is left unchanged); results in input order.
+// Returns false if an RMP could not be built or solved (not if one is infeasible).
+bool run_sweep(const Instance& instance, const std::vector<Settings>& scenarios, const SweepOptions& options,
+               std::vector<ScenarioResult>& results);
+
+// One block per scenario, in input order:
+//   SCENARIO <i> CO2 <c> CAPITAL <k> OBJ <v> BOUND <lb> ROUNDS <n> COLUMNS <m> ITER <pivots>
+//            STATUS <optimal|gap|tailing|limit> SECONDS <s> CHAIN <c> WARM <0|1>
+//                                          (or "... INFEASIBLE" instead of OBJ ... STATUS ...)
+//   flow(<from>,<to>,<product>,<value>).                           nonzero flows of the LP
+//   END <i>
+// and a last line "SWEEP SCENARIOS <n> CHAINS <c> SECONDS <total of the scenarios>".
+void write_sweep_report(std::ostream& os, const Instance& instance, const SweepOptions& options,
+                        const std::vector<ScenarioResult>& results);
@@ -0,0 +1,22 @@
+#pragma once
+#include <cmath>
+#include <iostream>
+
+// Minimal checks for the test executables: a failed check is printed with its location and
+// counted, main returns check_result() so ctest sees the failure.
+inline int& check_failures() { static int failures = 0; return failures; }
+
+inline bool check(bool ok, const char* what, const char* file, int line)
+{
+  if (!ok) { std::cerr << file << ":" << line << ": check failed: " << what << "\n"; ++check_failures(); }
+  return ok;
+}
+
+#define CHECK(cond) check((cond), #cond, __FILE__, __LINE__)
+#define CHECK_NEAR(a, b, eps) check(std::fabs((a) - (b)) <= (eps), #a " == " #b, __FILE__, __LINE__)
+
+inline int check_result()
+{
+  if (check_failures()) std::cerr << check_failures() << " check(s) failed\n";
+  return check_failures() ? 1 : 0;
+}
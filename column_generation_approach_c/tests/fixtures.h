@@ -0,0 +1,25 @@
+#pragma once
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "check.h"
+#include "instance.h"
+#include "instance_generator.h"
+#include "instance_loader.h"
+
+// A generated instance the way lno_rmp_stdin sees it: written as json and read back by the
+// json loader. The objects live in arena; loaded, if given, receives the loader's view. A
+// failed load is a failed check and gives an empty instance.
+inline Instance generated_instance(const GeneratorOptions& options, Arena& arena, LoadedInstance* loaded = nullptr)
+{
+  GeneratedInstance generated;
+  generate_instance(options, generated);
+  std::ostringstream json;
+  write_instance_json(json, generated);
+  LoadedInstance li;
+  std::string error;
+  if (!CHECK(load_instance_json(json.str(), arena, li, error))) { std::cerr << error << "\n"; li = LoadedInstance(); }
+  Instance inst = build_instance(li.settings, li.locations, li.transportResources, li.products, li.routes);
+  if (loaded) *loaded = std::move(li);
+  return inst;
+}
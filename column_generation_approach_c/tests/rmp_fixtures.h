@@ -0,0 +1,16 @@
+#pragma once
+#include "check.h"
+#include "column_generation.h"
+#include "fixtures.h"
+
+// LP optimum of a session built from scratch on the instance, by column generation to the end
+inline double cold_optimum(const Instance& inst, WorkStealingPool& pool)
+{
+  RmpSession session(inst);
+  ColumnGenerationOptions options;
+  ColumnGenerationResult result;
+  if (!CHECK(session.init() == SCIP_OKAY)) return 0.0;
+  if (!CHECK(run_column_generation(session, options, pool, result) == SCIP_OKAY)) return 0.0;
+  CHECK(result.optimal);
+  return result.objective;
+}
@@ -0,0 +1,66 @@
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include "check.h"
+#include "column_pool.h"
+#include "fixtures.h"
+
+// A saved column pool must load back completely, also with names that are not single tokens.
+
+namespace {
+
+const char* POOL = "test_column_pool.pool";
+
+void test_round_trip()
+{
+  GeneratorOptions options;
+  options.locations = 10;
+  options.products = 4;
+  options.transportResources = 3;
+  options.seed = 2;
+  Arena arena;
+  const Instance inst = generated_instance(options, arena);
+  if (!CHECK(inst.T == 3 && inst.P == 4)) return;
+  inst.transportResources[0]->name = "rail car";
+  inst.products[0]->name = "steel = coils";
+  inst.products[1]->name = "ore 50%";
+
+  // every product that fits alone, and every pair of them that fits together
+  ColumnPool pool(inst);
+  for (size_t t=0; t<inst.T; ++t) {
+    const int capacity = (int)std::floor(inst.trCapacity[t] + 1e-9);
+    auto size = [&](size_t p) { return (int)std::ceil(inst.productSize[p] - 1e-9); };
+    for (size_t p=0; p<inst.P; ++p) {
+      if (!inst.valid(p, t) || size(p) > capacity) continue;
+      pool.insert((int)t, {{(int)p, 1}});
+      for (size_t q=p+1; q<inst.P; ++q)
+        if (inst.valid(q, t) && size(p) + size(q) <= capacity) pool.insert((int)t, {{(int)p, 1}, {(int)q, 1}});
+    }
+  }
+  CHECK(pool.size() > 0);
+  if (!CHECK(pool.save(POOL))) return;
+
+  std::ifstream in(POOL);
+  std::ostringstream text;
+  text << in.rdbuf();
+  CHECK(text.str().find("rail car") == std::string::npos);
+  CHECK(text.str().find("steel = coils") == std::string::npos);
+
+  ColumnPool loaded(inst);
+  std::string error;
+  size_t skipped = 99;
+  CHECK(loaded.load(POOL, error, &skipped));
+  CHECK(skipped == 0);
+  CHECK(loaded.size() == pool.size());
+  std::remove(POOL);
+}
+
+} // namespace
+
+int main()
+{
+  test_round_trip();
+  return check_result();
+}
@@ -0,0 +1,17 @@
+# controller.py reads facts through facts_to_json when it drives lno_rmp_stdin, and through the
+# C++ fact reader with lno_core: both must give the same instance.
+# usage: python3 test_controller_facts.py <test_loaders> <controller dir> <facts.lp>
+import json, os, subprocess, sys, tempfile
+
+test_loaders, controller_dir, facts_path = sys.argv[1:4]
+sys.path.insert(0, controller_dir)
+from controller import facts_to_json
+
+with open(facts_path) as f:
+    J = facts_to_json(f.readlines())
+with tempfile.NamedTemporaryFile('w', suffix='.json', delete=False) as out:
+    json.dump(J, out)
+try:
+    sys.exit(subprocess.call([test_loaders, '--same', facts_path, out.name]))
+finally:
+    os.remove(out.name)
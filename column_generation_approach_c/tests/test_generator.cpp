@@ -0,0 +1,85 @@
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include "check.h"
+#include "instance_generator.h"
+
+// generate_instance must give the same instance for the same options on every platform.
+
+namespace {
+
+std::string json_of(const GeneratorOptions& options)
+{
+  GeneratedInstance instance;
+  generate_instance(options, instance);
+  std::ostringstream out;
+  write_instance_json(out, instance);
+  return out.str();
+}
+
+std::uint64_t fnv1a(const std::string& text)
+{
+  std::uint64_t h = 1469598103934665603ull;
+  for (unsigned char c: text) { h ^= c; h *= 1099511628211ull; }
+  return h;
+}
+
+void test_same_seed()
+{
+  GeneratorOptions options;
+  options.locations = 200;
+  options.products = 20;
+  options.imbalance = 0.5;
+  options.seed = 42;
+  const std::string first = json_of(options);
+  CHECK(first == json_of(options));
+
+  options.seed = 43;
+  CHECK(first != json_of(options));
+}
+
+// the draws come from mt19937_64 alone, so this value holds across standard libraries;
+// it changes with the generator, then update it on purpose
+const std::uint64_t GOLDEN = 0x94b631197be8131full;
+
+void test_golden()
+{
+  GeneratorOptions options;
+  options.locations = 30;
+  options.products = 4;
+  const std::uint64_t h = fnv1a(json_of(options));
+  if (!CHECK(h == GOLDEN)) std::cerr << "fingerprint " << std::hex << h << "\n";
+}
+
+void test_balanced()
+{
+  GeneratorOptions options;
+  options.locations = 100;
+  options.products = 30;
+  options.terminals = 0.2;
+  options.imbalance = 0.8;
+  options.seed = 5;
+  GeneratedInstance instance;
+  generate_instance(options, instance);
+  CHECK(instance.products.size() == 30);
+  for (const auto& product: instance.products) {
+    int sum = 0, sources = 0, sinks = 0;
+    for (const auto& [l, units]: product.netSupplyDemand) {
+      sum += units;
+      (units > 0 ? sources : sinks) += 1;
+    }
+    CHECK(sum == 0);
+    CHECK(sources >= 1);
+    CHECK(sinks >= 1);
+  }
+}
+
+} // namespace
+
+int main()
+{
+  test_same_seed();
+  test_golden();
+  test_balanced();
+  return check_result();
+}
@@ -0,0 +1,145 @@
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include "asp_reader.h"
+#include "check.h"
+#include "fixtures.h"
+#include "instance.h"
+#include "instance_generator.h"
+#include "instance_loader.h"
+
+// The json loader and the ASP fact reader must build the same instance from the same data.
+// Their dense ids differ (json key order vs. name order), so instances are compared by names.
+// usage: test_loaders <instance_paper.lp> <instance_paper.json>
+//        test_loaders --same <facts.lp> <facts.json>     only compares the two, for json written
+//                                                        elsewhere (controller.py facts_to_json)
+
+namespace {
+
+// everything a loaded instance says, ordered by names
+std::string describe(const LoadedInstance& li)
+{
+  std::ostringstream out;
+  out << "settings " << li.settings.co2Costs << " " << li.settings.capitalCosts << "\n";
+  std::set<std::string> locations;
+  for (const auto* l: li.locations) locations.insert(std::string(l->name));
+  for (const auto& name: locations) out << "location " << name << "\n";
+
+  std::map<std::string, std::string> lines;
+  for (const auto* t: li.transportResources) {
+    std::ostringstream line;
+    line << t->capacity << " " << t->co2Emissions << " " << t->cost << " " << t->speed;
+    lines["tr " + std::string(t->name)] = line.str();
+  }
+  for (const auto* p: li.products) {
+    std::ostringstream line;
+    std::set<std::string> valid;
+    for (const auto* t: p->validTR) valid.insert(std::string(t->name));
+    std::map<std::string, int> nsd;
+    for (const auto& [l, units]: p->netSupplyDemand) if (units != 0) nsd[std::string(l->name)] = units;
+    line << p->size << " " << p->value << " valid";
+    for (const auto& name: valid) line << " " << name;
+    line << " nsd";
+    for (const auto& [name, units]: nsd) line << " " << name << "=" << units;
+    lines["product " + std::string(p->name)] = line.str();
+  }
+  for (const auto* r: li.routes) {
+    std::map<std::string, double> trs;
+    for (const auto& [t, distance]: r->transportResources) trs[std::string(t->name)] = distance;
+    std::ostringstream line;
+    for (const auto& [name, distance]: trs) line << " " << name << ":" << distance;
+    lines["route " + std::string(r->from->name) + "->" + std::string(r->to->name)] += line.str();
+  }
+  for (const auto& [key, line]: lines) out << key << " " << line << "\n";
+  return out.str();
+}
+
+void check_same(const LoadedInstance& json, const LoadedInstance& facts)
+{
+  const std::string a = describe(json), b = describe(facts);
+  if (!CHECK(a == b)) std::cerr << "json:\n" << a << "facts:\n" << b;
+}
+
+// instance_paper.lp through both loaders, and a few of its numbers
+void test_instance_paper(const char* factsPath, const char* jsonPath)
+{
+  Arena jsonArena, factsArena;
+  LoadedInstance json, facts;
+  std::string error;
+  std::ifstream in(jsonPath);
+  if (!CHECK(load_instance_json(in, jsonArena, json, error))) { std::cerr << error << "\n"; return; }
+  if (!CHECK(load_instance_asp(factsPath, FACT_FORMAT_SETTINGS, factsArena, facts, error))) { std::cerr << error << "\n"; return; }
+  check_same(json, facts);
+
+  const Instance inst = build_instance(facts.settings, facts.locations, facts.transportResources, facts.products, facts.routes);
+  CHECK(inst.L == 6);  // l6 is only named by routes
+  CHECK(inst.T == 2);
+  CHECK(inst.P == 1);  // partTR(p2, ...) names an undeclared part
+  CHECK(inst.R == 10);
+  CHECK(inst.routeTR.size() == 18);
+  int supply = 0, demand = 0;
+  for (int v: inst.netSupplyDemand) (v > 0 ? supply : demand) += v;
+  CHECK(supply == 22);
+  CHECK(demand == -22);
+
+  // route(l1,l3,tr1,4,..) and route(l1,l3,tr1,3,..): the shorter one is kept
+  const Route* route = facts.routeKeys.at("l1->l3");
+  for (const auto& [t, distance]: route->transportResources)
+    if (t->name == "tr1") CHECK(distance == 3);
+}
+
+// any facts file against a json of the same data
+void test_same(const char* factsPath, const char* jsonPath)
+{
+  Arena jsonArena, factsArena;
+  LoadedInstance json, facts;
+  std::string error;
+  std::ifstream in(jsonPath);
+  if (!CHECK(load_instance_json(in, jsonArena, json, error))) { std::cerr << error << "\n"; return; }
+  if (!CHECK(load_instance_asp(factsPath, FACT_FORMAT_SETTINGS, factsArena, facts, error))) { std::cerr << error << "\n"; return; }
+  check_same(json, facts);
+}
+
+// a generated instance written as json and as facts
+void test_generated()
+{
+  GeneratorOptions options;
+  options.locations = 40;
+  options.products = 6;
+  options.seed = 7;
+  Arena jsonArena, factsArena;
+  LoadedInstance json, facts;
+  generated_instance(options, jsonArena, &json);
+
+  // the same instance again, as facts
+  GeneratedInstance generated;
+  generate_instance(options, generated);
+  const char* factsPath = "test_loaders_generated.lp";
+  {
+    std::ofstream out(factsPath);
+    write_instance_facts(out, generated);
+  }
+  std::string error;
+  if (!CHECK(load_instance_asp(factsPath, FACT_FORMAT_SETTINGS, factsArena, facts, error))) { std::cerr << error << "\n"; return; }
+  std::remove(factsPath);
+  check_same(json, facts);
+  CHECK(json.locations.size() == 40);
+  CHECK(json.products.size() == 6);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  if (argc == 4 && std::string(argv[1]) == "--same") {
+    test_same(argv[2], argv[3]);
+    return check_result();
+  }
+  if (argc < 3) { std::cerr << "usage: test_loaders <instance_paper.lp> <instance_paper.json>\n"; return 2; }
+  test_instance_paper(argv[1], argv[2]);
+  test_generated();
+  return check_result();
+}
@@ -0,0 +1,176 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "check.h"
+#include "fixtures.h"
+#include "pricing.h"
+#include "thread_pool.h"
+
+// The knapsack pricing against enumeration of every packing that fits.
+
+namespace {
+
+const double EPS = 1e-6;
+
+// smallest reduced cost of a nonempty packing on the slot, by enumerating all of them
+// (+infinity if nothing fits)
+double brute_force_slot(const Instance& inst, size_t r, size_t slot, const double* duals, bool farkas)
+{
+  const int tr = inst.routeTR[slot];
+  const int capacity = (int)std::floor(inst.trCapacity[tr] + 1e-9);
+  std::vector<int> products;
+  for (size_t p=0; p<inst.P; ++p) if (inst.valid(p, tr) && inst.active(r, p)) products.push_back((int)p);
+
+  double best = std::numeric_limits<double>::infinity();
+  std::vector<std::tuple<int,int>> items;
+  // depth first over the products, each with every count that still fits
+  auto visit = [&](auto&& self, size_t i, int room) -> void {
+    if (i == products.size()) {
+      if (items.empty()) return;
+      double redcost = farkas ? 0.0 : packing_cost(inst, tr, inst.routeDistance[slot], items);
+      for (const auto& [p, units]: items) redcost -= units*duals[p];
+      best = std::min(best, redcost);
+      return;
+    }
+    const int p = products[i], size = (int)std::ceil(inst.productSize[p] - 1e-9);
+    self(self, i+1, room);
+    for (int units=1; size > 0 && units*size <= room; ++units) {
+      items.emplace_back(p, units);
+      self(self, i+1, room - units*size);
+      items.pop_back();
+    }
+  };
+  visit(visit, 0, capacity);
+  return best;
+}
+
+std::vector<double> random_duals(const Instance& inst, std::mt19937_64& rng, double hi)
+{
+  std::vector<double> duals(inst.R*inst.P);
+  for (auto& d: duals) d = -0.1*hi + 1.1*hi*(double)(rng() >> 11)*0x1.0p-53;
+  return duals;
+}
+
+void test_bounded_knapsack()
+{
+  std::mt19937_64 rng(3);
+  for (int round=0; round<200; ++round) {
+    const size_t n = 1 + rng()%4;
+    const int capacity = (int)(rng()%25);
+    std::vector<double> profit(n);
+    std::vector<int> size(n), bound(n), x;
+    for (size_t i=0; i<n; ++i) {
+      profit[i] = (double)(rng()%200) - 40.0;
+      size[i] = (int)(rng()%7);
+      bound[i] = (int)(rng()%6);
+    }
+    const double value = solve_bounded_knapsack(profit, size, bound, capacity, x);
+
+    // every x with x[i] <= bound[i] and total size <= capacity; items of size 0 are never packed
+    double best = 0.0;
+    std::vector<int> y(n, 0), limit(bound);
+    for (size_t i=0; i<n; ++i) if (size[i] <= 0) limit[i] = 0;
+    for (;;) {
+      int used = 0; double v = 0.0;
+      for (size_t i=0; i<n; ++i) { used += y[i]*size[i]; v += y[i]*profit[i]; }
+      if (used <= capacity) best = std::max(best, v);
+      size_t i = 0;
+      while (i < n && y[i] == limit[i]) y[i++] = 0;
+      if (i == n) break;
+      ++y[i];
+    }
+    CHECK_NEAR(value, best, EPS);
+
+    int used = 0; double v = 0.0;
+    for (size_t i=0; i<n; ++i) {
+      CHECK(x[i] >= 0 && x[i] <= bound[i]);
+      used += x[i]*size[i]; v += x[i]*profit[i];
+    }
+    CHECK(used <= capacity);
+    CHECK_NEAR(v, value, EPS);
+  }
+}
+
+void test_price_routes(bool farkas)
+{
+  GeneratorOptions options;
+  options.locations = 8;
+  options.products = 4;
+  options.transportResources = 3;
+  options.terminals = 0.5;
+  options.seed = 11;
+  Arena arena;
+  const Instance inst = generated_instance(options, arena);
+
+  // dual ranges around the trip costs, so that some slots improve and others do not
+  double tripCost = 0.0;
+  for (size_t k=0; k<inst.routeTR.size(); ++k) {
+    const int tr = inst.routeTR[k];
+    tripCost = std::max(tripCost, inst.routeDistance[k]*(inst.trCost[tr] + inst.settings.co2Costs*inst.trCo2Emissions[tr]));
+  }
+  std::mt19937_64 rng(farkas ? 5 : 4);
+  WorkStealingPool serial(1), parallel(4);
+  size_t improving = 0;
+  for (int round=0; round<10; ++round) {
+    const std::vector<double> duals = random_duals(inst, rng, farkas ? 100.0 : tripCost/4);
+
+    std::vector<double> best(inst.R, 0.0);
+    size_t expected = 0;
+    for (size_t r=0; r<inst.R; ++r)
+      for (size_t k=inst.routeTRStart[r]; k<inst.routeTRStart[r+1]; ++k) {
+        const double brute = brute_force_slot(inst, r, k, duals.data() + inst.rp(r, 0), farkas);
+        Packing packing;
+        std::vector<double> routeDuals(duals.begin() + inst.rp(r, 0), duals.begin() + inst.rp(r, 0) + inst.P);
+        const double knapsack = price_packing(inst, r, k, routeDuals, farkas, packing);
+        if (brute < -EPS) {
+          CHECK_NEAR(knapsack, brute, 1e-6*std::max(1.0, std::fabs(brute)));
+          best[r] = std::min(best[r], brute);
+          ++expected;
+        }
+        else CHECK(knapsack > -EPS);
+      }
+    improving += expected;
+
+    PricingOptions pricing;
+    std::vector<Packing> columns, parallelColumns;
+    std::vector<double> redcosts, parallelRedcosts;
+    const double mostNegative = price_routes(inst, duals.data(), farkas, pricing, serial, columns, redcosts);
+    price_routes(inst, duals.data(), farkas, pricing, parallel, parallelColumns, parallelRedcosts);
+    CHECK(columns.size() == expected);
+    CHECK(parallelColumns.size() == columns.size());
+    CHECK(parallelRedcosts == redcosts);
+    CHECK_NEAR(mostNegative, *std::min_element(best.begin(), best.end()), 1e-6*std::max(1.0, std::fabs(mostNegative)));
+
+    std::vector<double> found(inst.R, 0.0);
+    for (size_t i=0; i<columns.size(); ++i) {
+      const Packing& c = columns[i];
+      found[c.route] = std::min(found[c.route], redcosts[i]);
+      double redcost = farkas ? 0.0 : packing_cost(inst, c.transportResource, c.distance, c.items);
+      for (const auto& [p, units]: c.items) redcost -= units*duals[inst.rp(c.route, p)];
+      CHECK_NEAR(redcost, redcosts[i], 1e-6*std::max(1.0, std::fabs(redcost)));
+    }
+    for (size_t r=0; r<inst.R; ++r) CHECK_NEAR(found[r], best[r], 1e-6*std::max(1.0, std::fabs(best[r])));
+
+    // partial pricing stops early but only returns improving columns
+    pricing.maxColumns = 2;
+    columns.clear(); redcosts.clear();
+    price_routes(inst, duals.data(), farkas, pricing, serial, columns, redcosts);
+    CHECK(columns.size() == std::min<size_t>(2, expected));
+    for (double redcost: redcosts) CHECK(redcost < -pricing.tolerance);
+  }
+  CHECK(improving > 0);  // otherwise the duals test nothing
+}
+
+} // namespace
+
+int main()
+{
+  test_bounded_knapsack();
+  test_price_routes(false);
+  test_price_routes(true);
+  return check_result();
+}
@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <functional>
+#include <string>
+#include "check.h"
+#include "presolve.h"
+#include "replan.h"
+#include "rmp_fixtures.h"
+using namespace scip;
+
+// Column generation after Replanner edits on a live session must end at the optimum of a
+// session built from scratch on the edited instance.
+
+namespace {
+
+void test_replan()
+{
+  GeneratorOptions options;
+  options.locations = 20;
+  options.products = 3;
+  options.terminals = 0.3;
+  options.seed = 9;
+  Arena arena;
+  Instance inst = generated_instance(options, arena);
+
+  WorkStealingPool pool(2);
+  RmpSession session(inst);
+  Replanner replanner(inst, session);
+  ColumnGenerationOptions cgOptions;
+  if (!CHECK(session.init() == SCIP_OKAY)) return;
+
+  // each edit goes to the live session through the replanner; the cold instance gets the same
+  // change directly, before its session is built
+  Instance cold = inst;
+  auto step = [&](const char* what, const std::function<SCIP_RETCODE()>& edit) {
+    const size_t columns = session.columns().size();
+    if (!CHECK(edit() == SCIP_OKAY)) { std::cerr << what << "\n"; return; }
+    ColumnGenerationResult result;
+    if (!CHECK(run_column_generation(session, cgOptions, pool, result) == SCIP_OKAY)) return;
+    CHECK(result.optimal);
+    CHECK(session.columns().size() >= columns);  // replanning keeps the generated columns
+    const double expected = cold_optimum(cold, pool);
+    if (!CHECK_NEAR(result.objective, expected, 1e-6*std::max(1.0, std::fabs(expected))))
+      std::cerr << what << ": replanned " << result.objective << ", rebuilt " << expected << "\n";
+  };
+
+  step("initial", [] { return SCIP_OKAY; });
+
+  Settings settings = inst.settings;
+  settings.co2Costs *= 4;
+  settings.capitalCosts *= 0.25;
+  cold.settings = settings;
+  step("settings", [&] { return replanner.set_settings(settings); });
+
+  // a route the current flow uses; the generator's two-way ring keeps the network connected
+  size_t closed = 0;
+  for (size_t r=0; r<inst.R; ++r) for (size_t p=0; p<inst.P; ++p)
+    if (session.flow_value(r, p) > 1e-6) closed = r;
+  cold.routeEnabled[closed] = 0;
+  step("route closed", [&] { return replanner.set_route_enabled(closed, false); });
+
+  // one unit less from a source to a sink, and a new source and sink of two units
+  const size_t p = 0;
+  size_t source = inst.L, sink = inst.L, idle = inst.L;
+  for (size_t l=0; l<inst.L; ++l) {
+    const int v = inst.netSupplyDemand[inst.lp(l, p)];
+    if (v > 1 && source == inst.L) source = l;
+    else if (v < -1 && sink == inst.L) sink = l;
+  }
+  for (size_t l=0; l<inst.L; ++l)
+    if (inst.netSupplyDemand[inst.lp(l, p)] == 0 && idle == inst.L) idle = l;
+  if (!CHECK(source < inst.L && sink < inst.L && idle < inst.L)) return;
+  const int sourceValue = inst.netSupplyDemand[inst.lp(source, p)] - 1;
+  const int sinkValue = inst.netSupplyDemand[inst.lp(sink, p)] + 1;
+  cold.netSupplyDemand[cold.lp(source, p)] = sourceValue;
+  cold.netSupplyDemand[cold.lp(sink, p)] = sinkValue;
+  step("smaller supply and demand", [&] {
+    SCIP_CALL( replanner.set_net_supply_demand(source, p, sourceValue) );
+    return replanner.set_net_supply_demand(sink, p, sinkValue);
+  });
+  cold.netSupplyDemand[cold.lp(idle, p)] = 2;
+  cold.netSupplyDemand[cold.lp(sink, p)] = sinkValue - 2;
+  step("new supply", [&] {
+    SCIP_CALL( replanner.set_net_supply_demand(idle, p, 2) );
+    return replanner.set_net_supply_demand(sink, p, sinkValue - 2);
+  });
+
+  cold.routeEnabled[closed] = 1;
+  step("route reopened", [&] { return replanner.set_route_enabled(closed, true); });
+}
+
+// presolve kept the slots that dominate at the CO2 rate it saw: the replanner refuses what would
+// need the dropped ones, and a new capital cost rate still ends where a presolved rebuild does
+void test_presolved()
+{
+  GeneratorOptions options;
+  options.locations = 20;
+  options.products = 3;
+  options.terminals = 0.3;
+  options.seed = 9;
+  Arena arena;
+  const Instance original = generated_instance(options, arena);
+
+  Instance inst = original;
+  presolve_instance(inst);
+  WorkStealingPool pool(2);
+  RmpSession session(inst);
+  Replanner replanner(inst, session);
+  ColumnGenerationOptions cgOptions;
+  ColumnGenerationResult result;
+  if (!CHECK(session.init() == SCIP_OKAY)) return;
+  if (!CHECK(run_column_generation(session, cgOptions, pool, result) == SCIP_OKAY)) return;
+
+  Settings settings = inst.settings;
+  settings.co2Costs *= 4;
+  CHECK(replanner.set_settings(settings) == SCIP_INVALIDDATA);
+  CHECK(inst.settings.co2Costs == original.settings.co2Costs);
+  CHECK(replanner.set_transport_resource_enabled(0, false) == SCIP_INVALIDDATA);
+  CHECK(inst.trEnabled[0]);
+
+  settings = inst.settings;
+  settings.capitalCosts *= 3;
+  ColumnGenerationResult replanned;
+  if (!CHECK(replanner.set_settings(settings) == SCIP_OKAY)) return;
+  if (!CHECK(run_column_generation(session, cgOptions, pool, replanned) == SCIP_OKAY)) return;
+  CHECK(replanned.optimal);
+
+  Instance cold = original;
+  cold.settings = settings;
+  presolve_instance(cold);
+  const double expected = cold_optimum(cold, pool);
+  CHECK_NEAR(replanned.objective, expected, 1e-6*std::max(1.0, std::fabs(expected)));
+}
+
+} // namespace
+
+int main()
+{
+  test_replan();
+  test_presolved();
+  return check_result();
+}
@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include "check.h"
+#include "column_generation.h"
+#include "instance_loader.h"
+#include "snapshot.h"
+using namespace scip;
+
+// A snapshot saved after column generation must restore the same RMP in a fresh session, and
+// load into a session on a changed instance by names.
+// usage: test_snapshot <instance_paper.json>
+
+namespace {
+
+const char* SNAPSHOT = "test_snapshot.snap";
+
+// instance_paper.json with names that need escaping in a snapshot
+std::string renamed_paper(const char* jsonPath)
+{
+  std::ifstream in(jsonPath);
+  std::ostringstream text;
+  text << in.rdbuf();
+  std::string json = text.str();
+  auto rename = [&](const std::string& from, const std::string& to) {
+    const std::string key = "\"name\": \"" + from + "\"";
+    const size_t at = json.find(key);
+    if (CHECK(at != std::string::npos)) json.replace(at, key.size(), "\"name\": \"" + to + "\"");
+  };
+  rename("l1", "north yard");
+  rename("l4", "depot 4%");
+  rename("tr1", "rail car");
+  rename("p1", "steel = coils");
+  return json;
+}
+
+bool load(const std::string& json, Arena& arena, Instance& inst)
+{
+  LoadedInstance li;
+  std::string error;
+  if (!CHECK(load_instance_json(json, arena, li, error))) { std::cerr << error << "\n"; return false; }
+  inst = build_instance(li.settings, li.locations, li.transportResources, li.products, li.routes);
+  return true;
+}
+
+// column generation to optimality on an initialized session
+bool generate(RmpSession& session, WorkStealingPool& pool, ColumnGenerationResult& result)
+{
+  ColumnGenerationOptions options;
+  return CHECK(run_column_generation(session, options, pool, result) == SCIP_OKAY) && CHECK(result.optimal);
+}
+
+void test_round_trip(const std::string& json)
+{
+  Arena arena;
+  Instance inst;
+  if (!load(json, arena, inst)) return;
+  WorkStealingPool pool(1);
+
+  RmpSession session(inst);
+  ColumnGenerationResult first;
+  if (!CHECK(session.init() == SCIP_OKAY) || !generate(session, pool, first)) return;
+  CHECK(!session.columns().empty());
+  if (!CHECK(save_snapshot(session, SNAPSHOT) == SCIP_OKAY)) return;
+
+  // every name is a single token in the file
+  std::ifstream in(SNAPSHOT);
+  std::ostringstream text;
+  text << in.rdbuf();
+  CHECK(text.str().find("north%20yard") != std::string::npos);
+  CHECK(text.str().find("north yard") == std::string::npos);
+  CHECK(text.str().find("steel%20%3D%20coils") != std::string::npos);
+
+  // a fresh session starts at the saved optimum: same columns, same value, nothing to price
+  RmpSession restored(inst);
+  SnapshotLoad loaded;
+  if (!CHECK(restored.init() == SCIP_OKAY)) return;
+  if (!CHECK(load_snapshot(restored, SNAPSHOT, loaded) == SCIP_OKAY)) return;
+  CHECK(loaded.found);
+  CHECK(loaded.exact);
+  CHECK(loaded.columns == session.columns().size());
+  CHECK(loaded.columnsSkipped == 0);
+  CHECK(loaded.statuses > 0);
+  CHECK(loaded.statusesSkipped == 0);
+  CHECK(restored.columns().size() == session.columns().size());
+
+  ColumnGenerationResult second;
+  if (!generate(restored, pool, second)) return;
+  CHECK_NEAR(second.objective, first.objective, 1e-6*std::max(1.0, std::fabs(first.objective)));
+  CHECK(second.columns == 0);
+  CHECK(second.rounds == 1);
+}
+
+// the same snapshot on other cost rates: nothing is exact, every column is re-costed, and
+// column generation from it ends where a cold run does
+void test_changed_instance(const std::string& json)
+{
+  Arena arena;
+  Instance inst;
+  if (!load(json, arena, inst)) return;
+  inst.settings.co2Costs *= 3;
+  inst.settings.capitalCosts /= 2;
+  WorkStealingPool pool(1);
+
+  RmpSession cold(inst);
+  ColumnGenerationResult coldResult;
+  if (!CHECK(cold.init() == SCIP_OKAY) || !generate(cold, pool, coldResult)) return;
+
+  RmpSession warm(inst);
+  SnapshotLoad loaded;
+  if (!CHECK(warm.init() == SCIP_OKAY)) return;
+  if (!CHECK(load_snapshot(warm, SNAPSHOT, loaded) == SCIP_OKAY)) return;
+  CHECK(loaded.found);
+  CHECK(!loaded.exact);
+  CHECK(loaded.columns > 0);
+  CHECK(loaded.columnsSkipped == 0);
+  for (const auto& [id, packing]: warm.columns())
+    CHECK_NEAR(packing.cost, packing_cost(inst, packing.transportResource, packing.distance, packing.items), 1e-9);
+
+  ColumnGenerationResult warmResult;
+  if (!generate(warm, pool, warmResult)) return;
+  CHECK_NEAR(warmResult.objective, coldResult.objective, 1e-6*std::max(1.0, std::fabs(coldResult.objective)));
+}
+
+void test_missing_file(const std::string& json)
+{
+  Arena arena;
+  Instance inst;
+  if (!load(json, arena, inst)) return;
+  RmpSession session(inst);
+  SnapshotLoad loaded;
+  if (!CHECK(session.init() == SCIP_OKAY)) return;
+  CHECK(load_snapshot(session, "test_snapshot.missing", loaded) == SCIP_OKAY);
+  CHECK(!loaded.found);
+  CHECK(session.columns().empty());
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  if (argc < 2) { std::cerr << "usage: test_snapshot <instance_paper.json>\n"; return 2; }
+  const std::string json = renamed_paper(argv[1]);
+  test_round_trip(json);
+  test_changed_instance(json);
+  test_missing_file(json);
+  std::remove(SNAPSHOT);
+  return check_result();
+}
@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "check.h"
+#include "rmp_fixtures.h"
+#include "sweep.h"
+using namespace scip;
+
+// Every scenario of a warm-started sweep must end at the optimum of an independent solve on
+// its settings, however the scenarios are cut into chains.
+
+namespace {
+
+void test_read_scenarios()
+{
+  std::istringstream in("# co2 capital\n50 0.1\n\n  20 0.5 # cheap CO2\n");
+  std::vector<Settings> scenarios;
+  std::string error;
+  CHECK(read_scenarios(in, scenarios, error));
+  CHECK(scenarios.size() == 2);
+  if (scenarios.size() == 2) {
+    CHECK(scenarios[1].co2Costs == 20);
+    CHECK(scenarios[1].capitalCosts == 0.5);
+  }
+  std::istringstream bad("50 0.1\n50\n");
+  CHECK(!read_scenarios(bad, scenarios, error));
+  CHECK(!error.empty());
+}
+
+void test_sweep()
+{
+  GeneratorOptions options;
+  options.locations = 15;
+  options.products = 3;
+  options.terminals = 0.3;
+  options.seed = 21;
+  Arena arena;
+  const Instance inst = generated_instance(options, arena);
+
+  // a grid given out of order, so the sweep reorders it
+  std::vector<Settings> scenarios;
+  for (double co2: {80.0, 0.0, 40.0})
+    for (double capital: {0.5, 0.0, 0.1}) {
+      Settings s = inst.settings;
+      s.co2Costs = co2;
+      s.capitalCosts = capital;
+      scenarios.push_back(s);
+    }
+
+  WorkStealingPool pool(1);
+  std::vector<double> expected;
+  for (const auto& s: scenarios) {
+    Instance alone = inst;
+    alone.settings = s;
+    expected.push_back(cold_optimum(alone, pool));
+  }
+
+  for (size_t chains: {1, 3}) {
+    SweepOptions sweep;
+    sweep.chains = chains;
+    std::vector<ScenarioResult> results;
+    if (!CHECK(run_sweep(inst, scenarios, sweep, results))) continue;
+    if (!CHECK(results.size() == scenarios.size())) continue;
+    std::set<size_t> used;
+    size_t warm = 0;
+    for (size_t i=0; i<results.size(); ++i) {
+      const ScenarioResult& r = results[i];
+      CHECK(r.settings.co2Costs == scenarios[i].co2Costs && r.settings.capitalCosts == scenarios[i].capitalCosts);
+      CHECK(r.feasible);
+      CHECK(r.optimal);
+      if (!CHECK_NEAR(r.objective, expected[i], 1e-6*std::max(1.0, std::fabs(expected[i]))))
+        std::cerr << "chains " << chains << " scenario " << i << ": sweep " << r.objective << ", alone " << expected[i] << "\n";
+      used.insert(r.chain);
+      warm += r.warm;
+    }
+    CHECK(used.size() == chains);
+    CHECK(warm == scenarios.size() - chains);  // all but the first of every chain
+  }
+}
+
+} // namespace
+
+int main()
+{
+  test_read_scenarios();
+  test_sweep();
+  return check_result();
+}
@@ -0,0 +1,107 @@
+//
+// Work-stealing thread pool for the parallel parts of the solver.
+//
+
+#include "thread_pool.h"
+
+using namespace std;
+
+WorkStealingPool::WorkStealingPool(size_t threads) {
+  if (threads == 0)
+    threads = max<size_t>(1, thread::hardware_concurrency());
+
+  for (size_t i = 0; i < threads; ++i)
+    _queues.push_back(make_unique<Queue>());
+  for (size_t i = 1; i < threads; ++i)
+    _threads.emplace_back(&WorkStealingPool::worker, this, i);
+}
+
+WorkStealingPool::~WorkStealingPool() {
+  {
+    lock_guard<mutex> guard(_lock);
+    _stop = true;
+  }
+  _wake.notify_all();
+  for (auto &t : _threads)
+    t.join();
+}
+
+void WorkStealingPool::parallel_for(size_t n, const function<void(size_t)> &task) {
+  if (n == 0)
+    return;
+
+  // deal the tasks out round robin, stealing evens out the rest
+  for (size_t i = 0; i < n; ++i) {
+    Queue &queue = *_queues[i % _queues.size()];
+    lock_guard<mutex> guard(queue.lock);
+    queue.tasks.push_back(i);
+  }
+
+  {
+    lock_guard<mutex> guard(_lock);
+    _task = &task;
+    ++_generation;
+  }
+  _wake.notify_all();
+
+  drain(0, task);
+
+  // a worker may still run its last task; none may keep a pointer to this task afterwards
+  unique_lock<mutex> guard(_lock);
+  _idle.wait(guard, [this] { return _active == 0; });
+  _task = nullptr;
+}
+
+void WorkStealingPool::worker(size_t self) {
+  size_t seen = 0;
+  for (;;) {
+    const function<void(size_t)> *task;
+    {
+      unique_lock<mutex> guard(_lock);
+      _wake.wait(guard, [&] { return _stop || (_task != nullptr && _generation != seen); });
+      if (_stop)
+        return;
+      seen = _generation;
+      task = _task;
+      ++_active;
+    }
+
+    drain(self, *task);
+
+    {
+      lock_guard<mutex> guard(_lock);
+      --_active;
+    }
+    _idle.notify_all();
+  }
+}
+
+void WorkStealingPool::drain(size_t self, const function<void(size_t)> &task) {
+  size_t i;
+  while (pop(self, i))
+    task(i);
+}
+
+bool WorkStealingPool::pop(size_t self, size_t &task) {
+  {
+    Queue &own = *_queues[self];
+    lock_guard<mutex> guard(own.lock);
+    if (!own.tasks.empty()) {
+      task = own.tasks.back();
+      own.tasks.pop_back();
+      return true;
+    }
+  }
+
+  for (size_t k = 1; k < _queues.size(); ++k) {
+    Queue &victim = *_queues[(self + k) % _queues.size()];
+    lock_guard<mutex> guard(victim.lock);
+    if (!victim.tasks.empty()) {
+      task = victim.tasks.front();
+      victim.tasks.pop_front();
+      return true;
+    }
+  }
+
+  return false;
+}
@@ -0,0 +1,60 @@
+//
+// Work-stealing thread pool for the parallel parts of the solver.
+//
+
+#ifndef LNO_THREAD_POOL_H
+#define LNO_THREAD_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/** fixed set of workers, each with its own task deque
+ *
+ *  A worker takes tasks from the back of its own deque and, once that is empty, steals
+ *  from the front of the others, so uneven tasks (routes with many transport resources)
+ *  balance out. The thread calling parallel_for works as one of the workers.
+ */
+class WorkStealingPool {
+public:
+  /** threads includes the calling thread, 0 means one per hardware thread */
+  explicit WorkStealingPool(size_t threads = 0);
+  ~WorkStealingPool();
+
+  WorkStealingPool(const WorkStealingPool &) = delete;
+  WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+  size_t size() const { return _queues.size(); }
+
+  /** runs task(i) for every i in [0, n) and returns once all of them finished */
+  void parallel_for(size_t n, const function<void(size_t)> &task);
+
+private:
+  struct Queue {
+    mutex lock;
+    deque<size_t> tasks;
+  };
+
+  void worker(size_t self);
+  void drain(size_t self, const function<void(size_t)> &task);
+  bool pop(size_t self, size_t &task);
+
+  vector<unique_ptr<Queue>> _queues; // _queues[0] belongs to the calling thread
+  vector<thread> _threads;
+
+  mutex _lock;
+  condition_variable _wake;
+  condition_variable _idle;
+  const function<void(size_t)> *_task = nullptr;
+  size_t _generation = 0;
+  size_t _active = 0;
+  bool _stop = false;
+};
+
+#endif // LNO_THREAD_POOL_H
@@ -6,6 +6,46 @@ main_directory_tuning="testing/save-tuning"
 output_naive_tuning="${main_directory_tuning}/naive"
 output_optimised_tuning="${main_directory_tuning}/optimised"
 
+# C++ build (column_generation_approach_c/CMakeLists.txt); the SCIP targets are only built
+# when SCIP is found, pass e.g. CMAKE_PREFIX_PATH to point cmake at it. A failed build or
+# test run is reported in the exit status, the clingo runs below happen regardless.
+build_directory="${LNO_BUILD_DIR:-column_generation_approach_c/build}"
+cpp_status=0
+if cmake -S column_generation_approach_c -B "${build_directory}" \
+        && cmake --build "${build_directory}" -j "$(nproc 2>/dev/null || echo 2)"; then
+        # C++ regression tests (column_generation_approach_c/tests)
+        ctest --test-dir "${build_directory}" --output-on-failure
+        cpp_status=$?
+else
+        cpp_status=1
+        echo "--C++ build failed, regression tests skipped"
+fi
+
+# C++ benchmark: phase timings (load, build, lp, duals, pricing, cg) per instance.
+# The result is compared against testing/bench/baseline.json when it exists;
+# copy a run over the baseline to accept new timings.
+lno_bench="${LNO_BENCH:-${build_directory}/lno_bench}"
+output_bench="${main_directory}/bench"
+bench_reps="${BENCH_REPS:-20}"
+bench_instances="naive-encoding/instance.lp optimised_files/optimised_instances.lp optimised_files/factsASP.lp column_generation_approach_c/instance_paper.lp"
+
+bench_status=0
+if [ -x "${lno_bench}" ]; then
+        mkdir -p "${output_bench}"
+        bench_file="${output_bench}/bench-$(date +%Y%m%d-%H%M%S).json"
+        if [ -f "${output_bench}/baseline.json" ]; then
+                "${lno_bench}" --reps "${bench_reps}" --out "${bench_file}" --baseline "${output_bench}/baseline.json" ${bench_instances}
+                bench_status=$?
+        else
+                "${lno_bench}" --reps "${bench_reps}" --out "${bench_file}" ${bench_instances}
+                bench_status=$?
+        fi
+        echo "--benchmark written to ${bench_file}"
+else
+        echo "--benchmark skipped: ${lno_bench} not built (SCIP not found)"
+fi
+
+# clingo runs of the ASP encodings
 for i in $(seq 1 1 50); do
         output_file="${output_naive}/test${i}.json"
         clingo --outf=2 --quiet=1  "naive-encoding/instance.lp" "naive-encoding/encoding.lp" > "${output_file}"
@@ -28,3 +68,8 @@ for i in $(seq 1 1 50); do
         output_file="${output_optimised_tuning}/test${i}.json"
         clingo --outf=2 --quiet=1  "optimised_files/optimised_instances.lp" "optimised_files/optimised_second.lp" --save-progress > "${output_file}"
 done
+
+if [ "${cpp_status}" -ne 0 ]; then
+        exit "${cpp_status}"
+fi
+exit ${bench_status}